@@ -5,6 +5,10 @@ from .data_objects import (
     ByteStream,
     InflateStreamMeta,
     InflateStream,
+    SampleBatchMeta,
+    SampleBatch,
+    ShmSampleBatchMeta,
+    ShmSampleBatch,
 )
 
 from .data_pipelines import (
@@ -9,11 +9,32 @@
  */
 
 #include <memory>
+#include <span>
+
+#include "pybind11/numpy.h"
+#include "pybind11/stl.h"
 
 #include "DataFlow/csrc/data_objects/byte_stream.h"
 #include "DataFlow/csrc/data_objects/inflate_stream.h"
+#include "DataFlow/csrc/data_objects/sample_batch.h"
+#include "DataFlow/csrc/data_objects/shm_sample_batch.h"
 #include "DataFlow/csrc/module.h"
 
+namespace {
+/**
+ * @brief Expose a column as a numpy array without copying; the array keeps `base` alive.
+ */
+template <typename T>
+pybind11::array_t<T> AsArray(const std::vector<T>& column, pybind11::handle base) {
+  return pybind11::array_t<T>(column.size(), column.data(), base);
+}
+
+template <typename T>
+pybind11::array_t<T> AsArray(std::span<const T> column, pybind11::handle base) {
+  return pybind11::array_t<T>(column.size(), column.data(), base);
+}
+}  // namespace
+
 namespace data_flow {
 void add_data_object_bindings(pybind11::module& m) {
   /**
@@ -41,5 +62,215 @@ void add_data_object_bindings(pybind11::module& m) {
   pybind11::class_<InflateStream, std::shared_ptr<InflateStream>, DataObject>(m, "InflateStream")
       .def_property_readonly("data_meta",
                              [](std::shared_ptr<InflateStream> self) { return self->data_meta(); });
+
+  /**
+   * @brief SampleBatchMeta and SampleBatch bindings.
+   */
+  pybind11::class_<SampleBatchMeta, std::shared_ptr<SampleBatchMeta>, DataObjectMeta>(
+      m, "SampleBatchMeta")
+      .def_property_readonly("data_type", [](std::shared_ptr<SampleBatchMeta> self) {
+        return self->data_type().name();
+      });
+
+  pybind11::class_<SampleBatch, std::shared_ptr<SampleBatch>, DataObject>(m, "SampleBatch")
+      .def_property_readonly("data_meta",
+                             [](std::shared_ptr<SampleBatch> self) { return self->data_meta(); })
+      .def_property_readonly("rows", &SampleBatch::rows)
+      .def_property_readonly(
+          "sample_ids", [](std::shared_ptr<SampleBatch> self) { return self->sample_ids(); })
+      .def_property_readonly("group_ids",
+                             [](pybind11::object self) {
+                               return AsArray(self.cast<SampleBatch&>().group_ids(), self);
+                             })
+      .def_property_readonly("labels",
+                             [](pybind11::object self) -> pybind11::array {
+                               const auto& batch = self.cast<SampleBatch&>();
+                               if (batch.label_dtype() == LabelDType::kUint8) {
+                                 return AsArray(batch.labels_uint8(), self);
+                               }
+                               return AsArray(batch.labels(), self);
+                             })
+      .def_property_readonly("timestamps",
+                             [](pybind11::object self) {
+                               return AsArray(self.cast<SampleBatch&>().timestamps(), self);
+                             })
+      .def_property_readonly("group_offsets",
+                             [](pybind11::object self) {
+                               return AsArray(self.cast<SampleBatch&>().group_offsets(), self);
+                             })
+      .def_property_readonly("sparse_slots",
+                             [](std::shared_ptr<SampleBatch> self) {
+                               std::vector<int64_t> slots;
+                               for (const auto& column : self->sparse_columns()) {
+                                 slots.push_back(column.slot);
+                               }
+                               return slots;
+                             })
+      .def_property_readonly("dense_slots",
+                             [](std::shared_ptr<SampleBatch> self) {
+                               std::vector<int64_t> slots;
+                               for (const auto& column : self->dense_columns()) {
+                                 slots.push_back(column.slot);
+                               }
+                               return slots;
+                             })
+      .def(
+          "sparse",
+          [](pybind11::object self, int64_t slot) {
+            const auto* column = self.cast<SampleBatch&>().find_sparse(slot);
+            if (column == nullptr) {
+              throw pybind11::key_error(absl::StrFormat("sparse slot %d not found", slot));
+            }
+            pybind11::array ids = column->id_dtype == SparseIdDType::kUint32
+                                      ? pybind11::array(AsArray(column->ids32, self))
+                                      : pybind11::array(AsArray(column->ids, self));
+            return pybind11::make_tuple(ids, AsArray(column->weights, self),
+                                        AsArray(column->offsets, self));
+          },
+          pybind11::arg("slot"),
+          "Return (ids, weights, offsets) of a sparse slot; ids are uint64 or uint32.")
+      .def(
+          "dense",
+          [](pybind11::object self, int64_t slot) {
+            const auto* column = self.cast<SampleBatch&>().find_dense(slot);
+            if (column == nullptr) {
+              throw pybind11::key_error(absl::StrFormat("dense slot %d not found", slot));
+            }
+            const std::vector<size_t> shape{column->rows(), static_cast<size_t>(column->width)};
+            switch (column->dtype) {
+              case DenseDType::kFloat16:
+                return pybind11::array(pybind11::dtype("float16"), shape,
+                                       column->half_values.data(), self);
+              case DenseDType::kBFloat16:
+                // numpy 没有 bfloat16，以 uint16 位模式返回
+                return pybind11::array(pybind11::dtype("uint16"), shape,
+                                       column->half_values.data(), self);
+              default:
+                return pybind11::array(pybind11::dtype("float32"), shape, column->values.data(),
+                                       self);
+            }
+          },
+          pybind11::arg("slot"),
+          "Return the [rows, width] values of a dense slot: float32, float16, or the bit patterns "
+          "of bfloat16 as uint16 (e.g. torch.from_numpy(a).view(torch.bfloat16)).")
+      .def(
+          "dedup",
+          [](pybind11::object self, int64_t slot) {
+            const auto& batch = self.cast<SampleBatch&>();
+            const auto* column = batch.find_sparse(slot);
+            if (column == nullptr || column->inverse.size() != column->size()) {
+              throw pybind11::key_error(
+                  absl::StrFormat("sparse slot %d not found or not deduplicated", slot));
+            }
+            // 全局去重时 unique_ids 为整个 batch 共享的列表
+            const auto& unique = column->unique_ids.empty() && column->size() != 0
+                                     ? batch.unique_ids()
+                                     : column->unique_ids;
+            return pybind11::make_tuple(AsArray(unique, self), AsArray(column->inverse, self));
+          },
+          pybind11::arg("slot"),
+          "Return (unique_ids, inverse) of a sparse slot deduplicated by SparseDedup, where "
+          "ids == unique_ids[inverse].");
+
+  /**
+   * @brief ShmSampleBatchMeta and ShmSampleBatch bindings. Arrays view the shared memory slot and
+   * keep the batch alive; the slot is recycled once the batch and all its arrays are released.
+   */
+  pybind11::class_<ShmSampleBatchMeta, std::shared_ptr<ShmSampleBatchMeta>, DataObjectMeta>(
+      m, "ShmSampleBatchMeta")
+      .def_property_readonly("data_type", [](std::shared_ptr<ShmSampleBatchMeta> self) {
+        return self->data_type().name();
+      });
+
+  pybind11::class_<ShmSampleBatch, std::shared_ptr<ShmSampleBatch>, DataObject>(m,
+                                                                               "ShmSampleBatch")
+      .def_property_readonly("data_meta",
+                             [](std::shared_ptr<ShmSampleBatch> self) { return self->data_meta(); })
+      .def_property_readonly("rows", &ShmSampleBatch::rows)
+      .def_property_readonly("sample_ids",
+                             [](std::shared_ptr<ShmSampleBatch> self) {
+                               std::vector<std::string> ids;
+                               ids.reserve(self->rows());
+                               for (size_t i = 0; i < self->rows(); ++i) {
+                                 ids.emplace_back(self->sample_id(i));
+                               }
+                               return ids;
+                             })
+      .def_property_readonly("group_ids",
+                             [](pybind11::object self) {
+                               return AsArray(self.cast<ShmSampleBatch&>().group_ids(), self);
+                             })
+      .def_property_readonly("labels",
+                             [](pybind11::object self) -> pybind11::array {
+                               const auto& batch = self.cast<ShmSampleBatch&>();
+                               if (batch.label_dtype() == LabelDType::kUint8) {
+                                 return AsArray(batch.labels_uint8(), self);
+                               }
+                               return AsArray(batch.labels(), self);
+                             })
+      .def_property_readonly("timestamps",
+                             [](pybind11::object self) {
+                               return AsArray(self.cast<ShmSampleBatch&>().timestamps(), self);
+                             })
+      .def_property_readonly("group_offsets",
+                             [](pybind11::object self) {
+                               return AsArray(self.cast<ShmSampleBatch&>().group_offsets(), self);
+                             })
+      .def_property_readonly("sparse_slots", &ShmSampleBatch::sparse_slots)
+      .def_property_readonly("dense_slots", &ShmSampleBatch::dense_slots)
+      .def(
+          "sparse",
+          [](pybind11::object self, int64_t slot) {
+            auto column = self.cast<ShmSampleBatch&>().find_sparse(slot);
+            if (!column.has_value()) {
+              throw pybind11::key_error(absl::StrFormat("sparse slot %d not found", slot));
+            }
+            pybind11::array ids = column->id_dtype == SparseIdDType::kUint32
+                                      ? pybind11::array(AsArray(column->ids32, self))
+                                      : pybind11::array(AsArray(column->ids, self));
+            return pybind11::make_tuple(ids, AsArray(column->weights, self),
+                                        AsArray(column->offsets, self));
+          },
+          pybind11::arg("slot"),
+          "Return (ids, weights, offsets) of a sparse slot; ids are uint64 or uint32.")
+      .def(
+          "dense",
+          [](pybind11::object self, int64_t slot) {
+            auto column = self.cast<ShmSampleBatch&>().find_dense(slot);
+            if (!column.has_value()) {
+              throw pybind11::key_error(absl::StrFormat("dense slot %d not found", slot));
+            }
+            const std::vector<size_t> shape{self.cast<ShmSampleBatch&>().rows(),
+                                            static_cast<size_t>(column->width)};
+            switch (column->dtype) {
+              case DenseDType::kFloat16:
+                return pybind11::array(pybind11::dtype("float16"), shape,
+                                       column->half_values.data(), self);
+              case DenseDType::kBFloat16:
+                return pybind11::array(pybind11::dtype("uint16"), shape,
+                                       column->half_values.data(), self);
+              default:
+                return pybind11::array(pybind11::dtype("float32"), shape, column->values.data(),
+                                       self);
+            }
+          },
+          pybind11::arg("slot"),
+          "Return the [rows, width] values of a dense slot, with the dtypes of SampleBatch.dense.")
+      .def(
+          "dedup",
+          [](pybind11::object self, int64_t slot) {
+            const auto& batch = self.cast<ShmSampleBatch&>();
+            auto column = batch.find_sparse(slot);
+            if (!column.has_value() || column->inverse.size() != column->size()) {
+              throw pybind11::key_error(
+                  absl::StrFormat("sparse slot %d not found or not deduplicated", slot));
+            }
+            auto unique = column->unique_ids.empty() && column->size() != 0 ? batch.unique_ids()
+                                                                             : column->unique_ids;
+            return pybind11::make_tuple(AsArray(unique, self), AsArray(column->inverse, self));
+          },
+          pybind11::arg("slot"),
+          "Return (unique_ids, inverse) of a sparse slot deduplicated in the worker, see "
+          "SampleBatch.dedup.");
 }
 }  // namespace data_flow
\ No newline at end of file
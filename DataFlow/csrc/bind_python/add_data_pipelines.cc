@@ -9,16 +9,111 @@
  */
 
 #include <cstdio>
+#include <limits>
 #include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 
+#include "absl/strings/str_format.h"
 #include "glog/logging.h"
 #include "pybind11/stl.h"
 #include "pybind11/stl_bind.h"
 
 #include "DataFlow/csrc/data_pipelines/data_decompressor.h"
 #include "DataFlow/csrc/data_pipelines/data_reader.h"
+#include "DataFlow/csrc/data_pipelines/feature_generator.h"
+#include "DataFlow/csrc/data_pipelines/fused_text_sample_reader.h"
+#include "DataFlow/csrc/data_pipelines/group_batcher.h"
+#include "DataFlow/csrc/data_pipelines/interleaved_text_sample_reader.h"
+#include "DataFlow/csrc/data_pipelines/multi_process_reader.h"
+#include "DataFlow/csrc/data_pipelines/sparse_dedup.h"
+#include "DataFlow/csrc/data_pipelines/text_sample_parser.h"
 #include "DataFlow/csrc/module.h"
 
+namespace {
+using data_flow::FgOpSpec;
+using data_flow::TextSampleOptions;
+
+/**
+ * @brief Convert a python dict such as {"op": "hash_mod", "inputs": [1001], "output": 5001,
+ * "num_buckets": 1000} to a FgOpSpec.
+ */
+FgOpSpec FgOpSpecFromDict(const pybind11::dict& d) {
+  FgOpSpec spec;
+  auto status_or_type = data_flow::FgOpTypeFromName(d["op"].cast<std::string>());
+  if (!status_or_type.ok()) {
+    throw std::invalid_argument(std::string(status_or_type.status().message()));
+  }
+  spec.type = status_or_type.value();
+  spec.inputs = d["inputs"].cast<std::vector<int64_t>>();
+  spec.output = d["output"].cast<int64_t>();
+
+  if (d.contains("num_buckets")) spec.num_buckets = d["num_buckets"].cast<uint64_t>();
+  if (d.contains("salt")) spec.salt = d["salt"].cast<uint64_t>();
+  if (d.contains("boundaries")) spec.boundaries = d["boundaries"].cast<std::vector<float>>();
+  if (d.contains("min_value")) spec.min_value = d["min_value"].cast<float>();
+  if (d.contains("max_value")) spec.max_value = d["max_value"].cast<float>();
+  if (d.contains("max_length")) spec.max_length = d["max_length"].cast<uint32_t>();
+  if (d.contains("keep_last")) spec.keep_last = d["keep_last"].cast<bool>();
+  return spec;
+}
+
+/**
+ * @brief Projection and row predicate keyword arguments shared by the text sample pipelines.
+ */
+TextSampleOptions MakeTextSampleOptions(std::optional<std::vector<int64_t>> sparse_slots,
+                                        std::optional<std::vector<int64_t>> dense_slots,
+                                        std::vector<float> labels, int64_t min_timestamp,
+                                        int64_t max_timestamp, float negative_sample_rate,
+                                        uint64_t seed) {
+  TextSampleOptions options;
+  options.sparse_slots = std::move(sparse_slots);
+  options.dense_slots = std::move(dense_slots);
+  options.labels = std::move(labels);
+  options.min_timestamp = min_timestamp;
+  options.max_timestamp = max_timestamp;
+  options.negative_sample_rate = negative_sample_rate;
+  options.seed = seed;
+  return options;
+}
+
+/**
+ * @brief Input of a pipeline transforming SampleBatch. Those pipelines CHECK their input type, so
+ * reject other inputs, e.g. the ShmSampleBatch of MultiProcessReader, with a Python exception.
+ */
+std::shared_ptr<data_flow::DataPipeline> SampleBatchInput(pybind11::handle input_h,
+                                                          std::string_view pipeline) {
+  auto input_pipeline = input_h.cast<std::shared_ptr<data_flow::DataPipeline>>();
+  const auto type = input_pipeline->output_data_meta()->data_type();
+  if (type != typeid(data_flow::SampleBatch)) {
+    throw std::invalid_argument(absl::StrFormat(
+        "%s needs an input pipeline producing SampleBatch, got %s", pipeline,
+        type == typeid(data_flow::ShmSampleBatch) ? "ShmSampleBatch" : type.name()));
+  }
+  return input_pipeline;
+}
+
+template <typename T>
+T ValueOrThrow(absl::StatusOr<T> status_or) {
+  if (!status_or.ok()) {
+    throw std::invalid_argument(std::string(status_or.status().message()));
+  }
+  return status_or.value();
+}
+
+/**
+ * @brief Output dtype keyword arguments of the text sample pipelines.
+ */
+void SetOutputDTypes(TextSampleOptions* options, std::string_view sparse_id_dtype,
+                     std::string_view dense_dtype, std::string_view label_dtype) {
+  options->sparse_id_dtype = ValueOrThrow(data_flow::SparseIdDTypeFromName(sparse_id_dtype));
+  options->dense_dtype = ValueOrThrow(data_flow::DenseDTypeFromName(dense_dtype));
+  options->label_dtype = ValueOrThrow(data_flow::LabelDTypeFromName(label_dtype));
+}
+}  // namespace
+
 namespace data_flow {
 void add_data_pipeline_bindings(pybind11::module& m) {
   /**
@@ -29,14 +124,45 @@ void add_data_pipeline_bindings(pybind11::module& m) {
 
   pybind11::enum_<DataReader::FileSource>(cls, "FileSource")
       .value("kFileList", DataReader::FileSource::kFileList)
-      .value("kStringStream", DataReader::FileSource::kStringStream);
+      .value("kStringStream", DataReader::FileSource::kStringStream)
+      .value("kStream", DataReader::FileSource::kStream)
+      .value("kPattern", DataReader::FileSource::kPattern);
 
-  cls.def(pybind11::init([](pybind11::handle input_h, pybind11::handle file_source_h) {
+  cls.def(pybind11::init([](pybind11::handle input_h, pybind11::handle file_source_h, bool follow,
+                            int64_t idle_timeout_ms, size_t num_threads, size_t lookahead,
+                            bool skip_empty, size_t readahead_chunk_size, size_t readahead_window,
+                            size_t readahead_threads) {
             auto file_source = file_source_h.cast<DataReader::FileSource>();
             switch (file_source) {
               case DataReader::FileSource::kFileList: {
                 std::vector<std::string> files = pybind11::cast<std::vector<std::string>>(input_h);
-                return std::make_shared<DataReader>(std::move(files));
+                if (readahead_chunk_size == 0) {
+                  throw std::invalid_argument("readahead_chunk_size must be positive");
+                }
+                ReadaheadOptions readahead;
+                readahead.chunk_size = readahead_chunk_size;
+                readahead.window = readahead_window;
+                readahead.num_threads = readahead_threads;
+                return std::make_shared<DataReader>(std::move(files), file_source,
+                                                    StreamFileOptions{}, FileDiscoveryOptions{},
+                                                    readahead);
+              }
+              case DataReader::FileSource::kStream: {
+                std::vector<std::string> uris = pybind11::cast<std::vector<std::string>>(input_h);
+                StreamFileOptions options;
+                options.follow = follow;
+                options.idle_timeout_ms = idle_timeout_ms;
+                return std::make_shared<DataReader>(std::move(uris), file_source, options);
+              }
+              case DataReader::FileSource::kPattern: {
+                std::vector<std::string> patterns =
+                    pybind11::cast<std::vector<std::string>>(input_h);
+                FileDiscoveryOptions options;
+                options.num_threads = num_threads;
+                options.lookahead = lookahead;
+                options.skip_empty = skip_empty;
+                return std::make_shared<DataReader>(std::move(patterns), file_source,
+                                                    StreamFileOptions{}, options);
               }
               // case DataReader::FileSource::kStringStream: {
               //     auto string_stream = input_h.cast<std::shared_ptr<DataObject>>();
@@ -46,7 +172,14 @@ void add_data_pipeline_bindings(pybind11::module& m) {
                 throw std::invalid_argument("Unknown FileSource");
             }
           }),
-          pybind11::arg("input"), pybind11::arg("file_source"))
+          pybind11::arg("input"), pybind11::arg("file_source"), pybind11::arg("follow") = false,
+          pybind11::arg("idle_timeout_ms") = -1,
+          pybind11::arg("num_threads") = FileDiscoveryOptions{}.num_threads,
+          pybind11::arg("lookahead") = FileDiscoveryOptions{}.lookahead,
+          pybind11::arg("skip_empty") = FileDiscoveryOptions{}.skip_empty,
+          pybind11::arg("readahead_chunk_size") = ReadaheadOptions{}.chunk_size,
+          pybind11::arg("readahead_window") = ReadaheadOptions{}.window,
+          pybind11::arg("readahead_threads") = ReadaheadOptions{}.num_threads)
       .def_property_readonly("output_data_meta", &DataReader::output_data_meta)
       .def("__iter__", [](std::shared_ptr<DataReader> self) {
         auto obj = GetDataPipelineIterator(std::reinterpret_pointer_cast<DataPipeline>(self));
@@ -70,5 +203,267 @@ void add_data_pipeline_bindings(pybind11::module& m) {
         VLOG(6) << "[DataDecompress] Iterator object: " << obj;
         return pybind11::reinterpret_borrow<pybind11::object>(obj);
       });
+
+  /**
+   * @brief FeatureGenerator bindings
+   */
+  pybind11::class_<FeatureGenerator, std::shared_ptr<FeatureGenerator>, DataPipeline>(
+      m, "FeatureGenerator")
+      .def(pybind11::init([](pybind11::handle input_h, pybind11::list specs_h, bool keep_inputs) {
+             auto input_pipeline = SampleBatchInput(input_h, "FeatureGenerator");
+             std::vector<FgOpSpec> specs;
+             for (auto spec_h : specs_h) {
+               specs.push_back(FgOpSpecFromDict(spec_h.cast<pybind11::dict>()));
+             }
+             return std::make_shared<FeatureGenerator>(input_pipeline, specs, keep_inputs);
+           }),
+           pybind11::arg("input_pipeline"), pybind11::arg("specs"),
+           pybind11::arg("keep_inputs") = true)
+      .def_property_readonly("output_data_meta", &FeatureGenerator::output_data_meta)
+      .def("__iter__", [](std::shared_ptr<FeatureGenerator> self) {
+        auto obj = GetDataPipelineIterator(std::reinterpret_pointer_cast<DataPipeline>(self));
+        VLOG(6) << "[FeatureGenerator] Iterator object: " << obj;
+        return pybind11::reinterpret_borrow<pybind11::object>(obj);
+      });
+
+  /**
+   * @brief TextSampleParser bindings
+   */
+  pybind11::class_<TextSampleParser, std::shared_ptr<TextSampleParser>, DataPipeline>(
+      m, "TextSampleParser")
+      .def(pybind11::init([](pybind11::handle input_h, size_t batch_size,
+                             std::optional<std::vector<int64_t>> sparse_slots,
+                             std::optional<std::vector<int64_t>> dense_slots,
+                             std::vector<float> labels, int64_t min_timestamp,
+                             int64_t max_timestamp, float negative_sample_rate, uint64_t seed,
+                             std::string sparse_id_dtype, std::string dense_dtype,
+                             std::string label_dtype) {
+             auto input_pipeline = input_h.cast<std::shared_ptr<DataPipeline>>();
+             auto options =
+                 MakeTextSampleOptions(std::move(sparse_slots), std::move(dense_slots),
+                                       std::move(labels), min_timestamp, max_timestamp,
+                                       negative_sample_rate, seed);
+             SetOutputDTypes(&options, sparse_id_dtype, dense_dtype, label_dtype);
+             return std::make_shared<TextSampleParser>(input_pipeline, batch_size, options);
+           }),
+           pybind11::arg("input_pipeline"), pybind11::arg("batch_size"),
+           pybind11::arg("sparse_slots") = pybind11::none(),
+           pybind11::arg("dense_slots") = pybind11::none(),
+           pybind11::arg("labels") = std::vector<float>{},
+           pybind11::arg("min_timestamp") = std::numeric_limits<int64_t>::min(),
+           pybind11::arg("max_timestamp") = std::numeric_limits<int64_t>::max(),
+           pybind11::arg("negative_sample_rate") = 1.0f, pybind11::arg("seed") = 0,
+           pybind11::arg("sparse_id_dtype") = "uint64", pybind11::arg("dense_dtype") = "float32",
+           pybind11::arg("label_dtype") = "float32")
+      .def_property_readonly("output_data_meta", &TextSampleParser::output_data_meta)
+      .def_property_readonly("rows_filtered", &TextSampleParser::rows_filtered)
+      .def("__iter__", [](std::shared_ptr<TextSampleParser> self) {
+        auto obj = GetDataPipelineIterator(std::reinterpret_pointer_cast<DataPipeline>(self));
+        VLOG(6) << "[TextSampleParser] Iterator object: " << obj;
+        return pybind11::reinterpret_borrow<pybind11::object>(obj);
+      });
+
+  /**
+   * @brief FusedTextSampleReader bindings
+   */
+  pybind11::class_<FusedTextSampleReader, std::shared_ptr<FusedTextSampleReader>, DataPipeline>(
+      m, "FusedTextSampleReader")
+      .def(pybind11::init([](std::vector<std::string> files, size_t batch_size, bool compressed,
+                             std::optional<std::vector<int64_t>> sparse_slots,
+                             std::optional<std::vector<int64_t>> dense_slots,
+                             std::vector<float> labels, int64_t min_timestamp,
+                             int64_t max_timestamp, float negative_sample_rate, uint64_t seed,
+                             std::string sparse_id_dtype, std::string dense_dtype,
+                             std::string label_dtype) {
+             auto options =
+                 MakeTextSampleOptions(std::move(sparse_slots), std::move(dense_slots),
+                                       std::move(labels), min_timestamp, max_timestamp,
+                                       negative_sample_rate, seed);
+             SetOutputDTypes(&options, sparse_id_dtype, dense_dtype, label_dtype);
+             return std::make_shared<FusedTextSampleReader>(std::move(files), batch_size,
+                                                            compressed, options);
+           }),
+           pybind11::arg("files"), pybind11::arg("batch_size"),
+           pybind11::arg("compressed") = true,
+           pybind11::arg("sparse_slots") = pybind11::none(),
+           pybind11::arg("dense_slots") = pybind11::none(),
+           pybind11::arg("labels") = std::vector<float>{},
+           pybind11::arg("min_timestamp") = std::numeric_limits<int64_t>::min(),
+           pybind11::arg("max_timestamp") = std::numeric_limits<int64_t>::max(),
+           pybind11::arg("negative_sample_rate") = 1.0f, pybind11::arg("seed") = 0,
+           pybind11::arg("sparse_id_dtype") = "uint64", pybind11::arg("dense_dtype") = "float32",
+           pybind11::arg("label_dtype") = "float32")
+      .def_property_readonly("output_data_meta", &FusedTextSampleReader::output_data_meta)
+      .def_property_readonly("rows_filtered", &FusedTextSampleReader::rows_filtered)
+      .def("__iter__", [](std::shared_ptr<FusedTextSampleReader> self) {
+        auto obj = GetDataPipelineIterator(std::reinterpret_pointer_cast<DataPipeline>(self));
+        VLOG(6) << "[FusedTextSampleReader] Iterator object: " << obj;
+        return pybind11::reinterpret_borrow<pybind11::object>(obj);
+      });
+
+  /**
+   * @brief InterleavedTextSampleReader bindings
+   */
+  pybind11::class_<InterleavedTextSampleReader, std::shared_ptr<InterleavedTextSampleReader>,
+                   DataPipeline>(m, "InterleavedTextSampleReader")
+      .def(pybind11::init([](pybind11::handle input_h, size_t batch_size, size_t num_threads,
+                             size_t max_open_streams, size_t queue_capacity,
+                             std::optional<std::vector<int64_t>> sparse_slots,
+                             std::optional<std::vector<int64_t>> dense_slots,
+                             std::vector<float> labels, int64_t min_timestamp,
+                             int64_t max_timestamp, float negative_sample_rate, uint64_t seed,
+                             std::string sparse_id_dtype, std::string dense_dtype,
+                             std::string label_dtype) {
+             auto input_pipeline = input_h.cast<std::shared_ptr<DataPipeline>>();
+             if (batch_size == 0) {
+               throw std::invalid_argument("batch_size must be positive");
+             }
+             auto options =
+                 MakeTextSampleOptions(std::move(sparse_slots), std::move(dense_slots),
+                                       std::move(labels), min_timestamp, max_timestamp,
+                                       negative_sample_rate, seed);
+             SetOutputDTypes(&options, sparse_id_dtype, dense_dtype, label_dtype);
+             InterleavedReaderOptions reader_options;
+             reader_options.num_threads = num_threads;
+             reader_options.max_open_streams = max_open_streams;
+             reader_options.queue_capacity = queue_capacity;
+             return std::make_shared<InterleavedTextSampleReader>(input_pipeline, batch_size,
+                                                                  options, reader_options);
+           }),
+           pybind11::arg("input_pipeline"), pybind11::arg("batch_size"),
+           pybind11::arg("num_threads") = InterleavedReaderOptions{}.num_threads,
+           pybind11::arg("max_open_streams") = InterleavedReaderOptions{}.max_open_streams,
+           pybind11::arg("queue_capacity") = InterleavedReaderOptions{}.queue_capacity,
+           pybind11::arg("sparse_slots") = pybind11::none(),
+           pybind11::arg("dense_slots") = pybind11::none(),
+           pybind11::arg("labels") = std::vector<float>{},
+           pybind11::arg("min_timestamp") = std::numeric_limits<int64_t>::min(),
+           pybind11::arg("max_timestamp") = std::numeric_limits<int64_t>::max(),
+           pybind11::arg("negative_sample_rate") = 1.0f, pybind11::arg("seed") = 0,
+           pybind11::arg("sparse_id_dtype") = "uint64", pybind11::arg("dense_dtype") = "float32",
+           pybind11::arg("label_dtype") = "float32")
+      .def_property_readonly("output_data_meta", &InterleavedTextSampleReader::output_data_meta)
+      .def_property_readonly("rows_filtered", &InterleavedTextSampleReader::rows_filtered)
+      .def("__iter__", [](std::shared_ptr<InterleavedTextSampleReader> self) {
+        auto obj = GetDataPipelineIterator(std::reinterpret_pointer_cast<DataPipeline>(self));
+        VLOG(6) << "[InterleavedTextSampleReader] Iterator object: " << obj;
+        return pybind11::reinterpret_borrow<pybind11::object>(obj);
+      });
+
+  /**
+   * @brief MultiProcessReader bindings. Each worker process runs a FusedTextSampleReader over its
+   * shard of the files, followed by a SparseDedup(dedup_slots, dedup_per_slot) with dedup.
+   */
+  pybind11::class_<MultiProcessReader, std::shared_ptr<MultiProcessReader>, DataPipeline>(
+      m, "MultiProcessReader")
+      .def(pybind11::init([](std::vector<std::string> files, size_t num_workers,
+                             size_t batch_size, bool compressed, size_t num_slots,
+                             size_t slot_size, std::optional<std::vector<int64_t>> sparse_slots,
+                             std::optional<std::vector<int64_t>> dense_slots,
+                             std::vector<float> labels, int64_t min_timestamp,
+                             int64_t max_timestamp, float negative_sample_rate, uint64_t seed,
+                             std::string sparse_id_dtype, std::string dense_dtype,
+                             std::string label_dtype, bool dedup,
+                             std::optional<std::vector<int64_t>> dedup_slots,
+                             bool dedup_per_slot) {
+             if (batch_size == 0) {
+               throw std::invalid_argument("batch_size must be positive");
+             }
+             auto options =
+                 MakeTextSampleOptions(std::move(sparse_slots), std::move(dense_slots),
+                                       std::move(labels), min_timestamp, max_timestamp,
+                                       negative_sample_rate, seed);
+             SetOutputDTypes(&options, sparse_id_dtype, dense_dtype, label_dtype);
+             // 去重在 worker 中完成，结果随 batch 写入共享内存
+             auto factory = [batch_size, compressed, options, dedup, dedup_slots,
+                             dedup_per_slot](std::vector<std::string> shard) {
+               std::shared_ptr<DataPipeline> reader = std::make_shared<FusedTextSampleReader>(
+                   std::move(shard), batch_size, compressed, options);
+               if (dedup) {
+                 reader = std::make_shared<SparseDedup>(reader, dedup_slots, dedup_per_slot);
+               }
+               return reader;
+             };
+             ShmRingOptions ring_options;
+             ring_options.num_slots = num_slots;
+             ring_options.slot_size = slot_size;
+             return std::make_shared<MultiProcessReader>(std::move(files), num_workers, factory,
+                                                         ring_options);
+           }),
+           pybind11::arg("files"), pybind11::arg("num_workers"), pybind11::arg("batch_size"),
+           pybind11::arg("compressed") = true,
+           pybind11::arg("num_slots") = ShmRingOptions{}.num_slots,
+           pybind11::arg("slot_size") = ShmRingOptions{}.slot_size,
+           pybind11::arg("sparse_slots") = pybind11::none(),
+           pybind11::arg("dense_slots") = pybind11::none(),
+           pybind11::arg("labels") = std::vector<float>{},
+           pybind11::arg("min_timestamp") = std::numeric_limits<int64_t>::min(),
+           pybind11::arg("max_timestamp") = std::numeric_limits<int64_t>::max(),
+           pybind11::arg("negative_sample_rate") = 1.0f, pybind11::arg("seed") = 0,
+           pybind11::arg("sparse_id_dtype") = "uint64", pybind11::arg("dense_dtype") = "float32",
+           pybind11::arg("label_dtype") = "float32", pybind11::arg("dedup") = false,
+           pybind11::arg("dedup_slots") = pybind11::none(),
+           pybind11::arg("dedup_per_slot") = true)
+      .def_property_readonly("output_data_meta", &MultiProcessReader::output_data_meta)
+      .def_property_readonly("num_workers", &MultiProcessReader::num_workers)
+      .def("__iter__", [](std::shared_ptr<MultiProcessReader> self) {
+        auto obj = GetDataPipelineIterator(std::reinterpret_pointer_cast<DataPipeline>(self));
+        VLOG(6) << "[MultiProcessReader] Iterator object: " << obj;
+        return pybind11::reinterpret_borrow<pybind11::object>(obj);
+      });
+
+  /**
+   * @brief GroupBatcher bindings
+   */
+  pybind11::class_<GroupBatcher, std::shared_ptr<GroupBatcher>, DataPipeline>(m, "GroupBatcher")
+      .def(pybind11::init([](pybind11::handle input_h, size_t max_rows, size_t max_groups,
+                             size_t window_batches, int64_t timeout_ms) {
+             auto input_pipeline = SampleBatchInput(input_h, "GroupBatcher");
+             GroupBatcherOptions options;
+             options.max_rows = max_rows;
+             options.max_groups = max_groups;
+             options.window_batches = window_batches;
+             options.timeout_ms = timeout_ms;
+             return std::make_shared<GroupBatcher>(input_pipeline, options);
+           }),
+           pybind11::arg("input_pipeline"), pybind11::arg("max_rows"),
+           pybind11::arg("max_groups") = GroupBatcherOptions{}.max_groups,
+           pybind11::arg("window_batches") = GroupBatcherOptions{}.window_batches,
+           pybind11::arg("timeout_ms") = GroupBatcherOptions{}.timeout_ms)
+      .def_property_readonly("output_data_meta", &GroupBatcher::output_data_meta)
+      .def("__iter__", [](std::shared_ptr<GroupBatcher> self) {
+        auto obj = GetDataPipelineIterator(std::reinterpret_pointer_cast<DataPipeline>(self));
+        VLOG(6) << "[GroupBatcher] Iterator object: " << obj;
+        return pybind11::reinterpret_borrow<pybind11::object>(obj);
+      });
+
+  /**
+   * @brief SparseDedup bindings
+   */
+  pybind11::class_<SparseDedup, std::shared_ptr<SparseDedup>, DataPipeline>(m, "SparseDedup")
+      .def(pybind11::init([](pybind11::handle input_h, std::optional<std::vector<int64_t>> slots,
+                             bool per_slot) {
+             auto input_pipeline = SampleBatchInput(input_h, "SparseDedup");
+             return std::make_shared<SparseDedup>(input_pipeline, slots, per_slot);
+           }),
+           pybind11::arg("input_pipeline"), pybind11::arg("slots") = pybind11::none(),
+           pybind11::arg("per_slot") = true)
+      .def_property_readonly("output_data_meta", &SparseDedup::output_data_meta)
+      .def_property_readonly("metrics",
+                             [](std::shared_ptr<SparseDedup> self) {
+                               const auto& metrics = self->metrics();
+                               pybind11::dict d;
+                               d["batches"] = metrics.batches;
+                               d["ids"] = metrics.ids;
+                               d["unique_ids"] = metrics.unique_ids;
+                               d["dedup_ratio"] = metrics.dedup_ratio();
+                               d["ns_per_id"] = metrics.ns_per_id();
+                               return d;
+                             })
+      .def("__iter__", [](std::shared_ptr<SparseDedup> self) {
+        auto obj = GetDataPipelineIterator(std::reinterpret_pointer_cast<DataPipeline>(self));
+        VLOG(6) << "[SparseDedup] Iterator object: " << obj;
+        return pybind11::reinterpret_borrow<pybind11::object>(obj);
+      });
 }
 }  // namespace data_flow
\ No newline at end of file
@@ -9,6 +9,7 @@
  */
 
 #pragma once
+#include <cstdint>
 #include <string>
 
 namespace data_flow {
@@ -22,5 +23,15 @@ struct Func {
     return str.size() >= suffix.size() &&
            str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
   }
+
+  // 64-bit finalizer of MurmurHash3, spreads integer keys over hash buckets (hash tables, FG)
+  static uint64_t mix64(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+  }
 };
 }  // namespace data_flow
\ No newline at end of file
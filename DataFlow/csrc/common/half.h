@@ -0,0 +1,163 @@
+/**
+ * @file half.h
+ * @brief Conversions between float and the 16-bit float formats float16 and bfloat16.
+ *
+ * Author: Jasmine (1011694931@qq.com)
+ * Created on: 2025-11-16
+ *
+ * Copyright (c) 2025 Jasmine. All rights reserved.
+ */
+
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace data_flow {
+
+/**
+ * @brief float16 (IEEE 754 binary16) and bfloat16 conversions, rounding to nearest even.
+ *
+ * The array conversions use F16C (float16) and AVX2 (bfloat16) when the CPU supports them,
+ * detected at run time since the library is not built with -march; the results are identical to
+ * the scalar conversions except for NaN payloads.
+ */
+struct Half {
+  static uint16_t from_float(float value) {
+    constexpr uint32_t kFloatInf = 255u << 23;
+    constexpr uint32_t kHalfOverflow = (127u + 16) << 23;
+    constexpr uint32_t kDenormMagic = ((127u - 15) + (23 - 10) + 1) << 23;
+
+    uint32_t x = std::bit_cast<uint32_t>(value);
+    const uint32_t sign = x & 0x80000000u;
+    x ^= sign;
+    uint32_t h;
+    if (x >= kHalfOverflow) {
+      h = x > kFloatInf ? 0x7E00 : 0x7C00;  // NaN : 溢出为 Inf
+    } else if (x < (113u << 23)) {
+      // 结果为非规格化数或 0：借助浮点加法完成舍入
+      const float sum = std::bit_cast<float>(x) + std::bit_cast<float>(kDenormMagic);
+      h = std::bit_cast<uint32_t>(sum) - kDenormMagic;
+    } else {
+      const uint32_t odd = (x >> 13) & 1;
+      x += (static_cast<uint32_t>(15 - 127) << 23) + 0xFFF + odd;
+      h = x >> 13;
+    }
+    return static_cast<uint16_t>(h | (sign >> 16));
+  }
+
+  static float to_float(uint16_t half) {
+    constexpr uint32_t kShiftedExp = 0x7C00u << 13;
+    uint32_t x = (half & 0x7FFFu) << 13;
+    const uint32_t exp = x & kShiftedExp;
+    x += (127u - 15) << 23;
+    if (exp == kShiftedExp) {
+      x += (128u - 16) << 23;  // Inf / NaN
+    } else if (exp == 0) {
+      x += 1u << 23;  // 非规格化数
+      x = std::bit_cast<uint32_t>(std::bit_cast<float>(x) - std::bit_cast<float>(113u << 23));
+    }
+    return std::bit_cast<float>(x | (static_cast<uint32_t>(half & 0x8000u) << 16));
+  }
+
+  static uint16_t bfloat16_from_float(float value) {
+    const uint32_t x = std::bit_cast<uint32_t>(value);
+    if ((x & 0x7FFFFFFFu) > 0x7F800000u) {
+      return static_cast<uint16_t>((x >> 16) | 0x40);  // 保持为 quiet NaN
+    }
+    return static_cast<uint16_t>((x + 0x7FFF + ((x >> 16) & 1)) >> 16);
+  }
+
+  static float bfloat16_to_float(uint16_t value) {
+    return std::bit_cast<float>(static_cast<uint32_t>(value) << 16);
+  }
+
+  static void from_floats(const float* src, size_t n, uint16_t* dst) {
+#if defined(__x86_64__)
+    if (HasF16C()) {
+      FromFloatsF16C(src, n, dst);
+      return;
+    }
+#endif
+    for (size_t i = 0; i < n; ++i) {
+      dst[i] = from_float(src[i]);
+    }
+  }
+
+  static void bfloat16_from_floats(const float* src, size_t n, uint16_t* dst) {
+#if defined(__x86_64__)
+    if (HasAVX2()) {
+      BFloat16FromFloatsAVX2(src, n, dst);
+      return;
+    }
+#endif
+    for (size_t i = 0; i < n; ++i) {
+      dst[i] = bfloat16_from_float(src[i]);
+    }
+  }
+
+#if defined(__x86_64__)
+ private:
+  static bool HasF16C() {
+    static const bool has = __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+    return has;
+  }
+
+  static bool HasAVX2() {
+    static const bool has = __builtin_cpu_supports("avx2");
+    return has;
+  }
+
+  __attribute__((target("avx,f16c"))) static void FromFloatsF16C(const float* src, size_t n,
+                                                                 uint16_t* dst) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+      const __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), h);
+    }
+    if (i < n) {
+      // 尾部不足 8 个，经栈上缓冲区转换
+      alignas(32) float tail[8] = {};
+      alignas(16) uint16_t out[8];
+      for (size_t j = i; j < n; ++j) {
+        tail[j - i] = src[j];
+      }
+      _mm_store_si128(reinterpret_cast<__m128i*>(out),
+                      _mm256_cvtps_ph(_mm256_load_ps(tail), _MM_FROUND_TO_NEAREST_INT));
+      for (size_t j = i; j < n; ++j) {
+        dst[j] = out[j - i];
+      }
+    }
+  }
+
+  __attribute__((target("avx2"))) static __m128i BFloat16x8(__m256 v) {
+    const __m256i x = _mm256_castps_si256(v);
+    const __m256i odd = _mm256_and_si256(_mm256_srli_epi32(x, 16), _mm256_set1_epi32(1));
+    const __m256i rounded = _mm256_srli_epi32(
+        _mm256_add_epi32(_mm256_add_epi32(x, _mm256_set1_epi32(0x7FFF)), odd), 16);
+    const __m256i nan = _mm256_or_si256(_mm256_srli_epi32(x, 16), _mm256_set1_epi32(0x40));
+    const __m256i is_nan = _mm256_castps_si256(_mm256_cmp_ps(v, v, _CMP_UNORD_Q));
+    const __m256i h = _mm256_blendv_epi8(rounded, nan, is_nan);
+    // packus 在 128 位 lane 内交错，重排后低 128 位即为 8 个结果
+    const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(h, h), 0xD8);
+    return _mm256_castsi256_si128(packed);
+  }
+
+  __attribute__((target("avx2"))) static void BFloat16FromFloatsAVX2(const float* src, size_t n,
+                                                                     uint16_t* dst) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), BFloat16x8(_mm256_loadu_ps(src + i)));
+    }
+    for (; i < n; ++i) {
+      dst[i] = bfloat16_from_float(src[i]);
+    }
+  }
+#endif
+};
+}  // namespace data_flow
@@ -0,0 +1,107 @@
+/**
+ * @file id_dedup_table.h
+ * @brief Definition of IdDedupTable, a reusable hash table mapping ids to their unique index.
+ *
+ * Author: Jasmine (1011694931@qq.com)
+ * Created on: 2025-11-15
+ *
+ * Copyright (c) 2025 Jasmine. All rights reserved.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "DataFlow/csrc/common/functions.h"
+
+namespace data_flow {
+
+/**
+ * @brief IdDedupTable assigns each distinct id of a round its index in the round's unique id list.
+ *
+ * Open addressing with linear probing; keys and bucket states are separate contiguous arrays. A
+ * bucket is occupied only if its epoch equals the current round, so starting a round is a counter
+ * increment: the table is never cleared and only reallocated when a round needs a larger capacity.
+ */
+class IdDedupTable {
+ public:
+  /**
+   * @brief Start a new round for at most max_ids insertions.
+   */
+  void reset(size_t max_ids) {
+    // 负载因子不超过 0.5
+    const size_t capacity = std::bit_ceil(std::max<size_t>(max_ids * 2, kMinCapacity));
+    if (capacity > capacity_) {
+      capacity_ = capacity;
+      keys_.reset(new uint64_t[capacity_]);
+      buckets_.reset(new Bucket[capacity_]());
+      epoch_ = 0;
+    }
+    if (++epoch_ == 0) {
+      // epoch 回绕，清空后从 1 重新开始
+      std::fill(buckets_.get(), buckets_.get() + capacity_, Bucket{});
+      epoch_ = 1;
+    }
+  }
+
+  /**
+   * @brief Map ids to unique indices: inverse[i] is the index of ids[i] in unique, and ids not
+   * seen before in this round are appended to unique. Id is uint64_t or uint32_t.
+   */
+  template <typename Id>
+  void dedup(std::span<const Id> ids, std::vector<uint64_t>* unique, uint32_t* inverse) {
+    const uint64_t mask = capacity_ - 1;
+    uint64_t hashes[kBlock];
+    for (size_t begin = 0; begin < ids.size(); begin += kBlock) {
+      const size_t n = std::min(kBlock, ids.size() - begin);
+      // 先批量计算哈希并预取桶，再逐个探测，隐藏 cache miss
+      for (size_t i = 0; i < n; ++i) {
+        hashes[i] = Func::mix64(ids[begin + i]) & mask;
+      }
+      for (size_t i = 0; i < n; ++i) {
+        __builtin_prefetch(&buckets_[hashes[i]]);
+        __builtin_prefetch(&keys_[hashes[i]]);
+      }
+      for (size_t i = 0; i < n; ++i) {
+        inverse[begin + i] = insert(ids[begin + i], hashes[i], mask, unique);
+      }
+    }
+  }
+
+  size_t capacity() const { return capacity_; }
+
+ private:
+  static constexpr size_t kMinCapacity = 1024;
+  static constexpr size_t kBlock = 16;
+
+  struct Bucket {
+    uint32_t epoch = 0;
+    uint32_t index = 0;
+  };
+
+  uint32_t insert(uint64_t id, uint64_t bucket, uint64_t mask, std::vector<uint64_t>* unique) {
+    while (buckets_[bucket].epoch == epoch_) {
+      if (keys_[bucket] == id) {
+        return buckets_[bucket].index;
+      }
+      bucket = (bucket + 1) & mask;
+    }
+    const auto index = static_cast<uint32_t>(unique->size());
+    keys_[bucket] = id;
+    buckets_[bucket] = Bucket{epoch_, index};
+    unique->push_back(id);
+    return index;
+  }
+
+  size_t capacity_ = 0;
+  uint32_t epoch_ = 0;
+  std::unique_ptr<uint64_t[]> keys_;
+  std::unique_ptr<Bucket[]> buckets_;
+};
+
+}  // namespace data_flow
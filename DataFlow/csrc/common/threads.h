@@ -0,0 +1,46 @@
+/**
+ * @file threads.h
+ * @brief Background threads of DataFlow, counted so that fork() can check that none is running.
+ *
+ * Author: Jasmine (1011694931@qq.com)
+ * Created on: 2025-11-20
+ *
+ * Copyright (c) 2025 Jasmine. All rights reserved.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <utility>
+
+namespace data_flow {
+
+struct Threads {
+  /**
+   * @brief Number of threads started with Start() that have not finished yet. A child forked
+   * while it is not 0 may inherit a lock held by one of them (e.g. FileSystemRegistry, glog).
+   */
+  static int64_t live() { return counter().load(std::memory_order_acquire); }
+
+  /**
+   * @brief std::thread running fn, counted in live() until fn returns.
+   */
+  template <typename Fn>
+  static std::thread Start(Fn fn) {
+    // 线程启动前计数，fork 检查不会漏掉正在启动的线程
+    counter().fetch_add(1, std::memory_order_acq_rel);
+    return std::thread([fn = std::move(fn)]() mutable {
+      fn();
+      counter().fetch_sub(1, std::memory_order_acq_rel);
+    });
+  }
+
+ private:
+  static std::atomic<int64_t>& counter() {
+    static std::atomic<int64_t> live{0};
+    return live;
+  }
+};
+}  // namespace data_flow
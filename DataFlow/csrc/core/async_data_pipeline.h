@@ -0,0 +1,60 @@
+/**
+ * @file async_data_pipeline.h
+ * @brief Definition of AsyncDataPipeline, a DataPipeline producing its DataObjects in coroutines.
+ *
+ * Author: Jasmine (1011694931@qq.com)
+ * Created on: 2025-11-18
+ *
+ * Copyright (c) 2025 Jasmine. All rights reserved.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "absl/status/statusor.h"
+
+#include "DataFlow/csrc/coro/scheduler.h"
+#include "DataFlow/csrc/coro/task.h"
+#include "data_object.h"
+#include "data_pipeline.h"
+
+namespace data_flow {
+
+/**
+ * @brief AsyncDataPipeline is a DataPipeline whose next DataObject is produced by a coroutine on
+ * the pipeline's Scheduler. Downstream coroutines co_await next_async(); next() is the synchronous
+ * adapter for the Python iterator and for synchronous downstream pipelines.
+ */
+struct AsyncDataPipeline : DataPipeline {
+  /**
+   * @brief Asynchronous next(): same result, but a coroutine waiting for data holds no thread.
+   */
+  virtual Task<absl::StatusOr<std::shared_ptr<DataObject>>> next_async() = 0;
+
+  /**
+   * @brief The scheduler running the coroutines of this pipeline.
+   */
+  virtual Scheduler& scheduler() = 0;
+
+  /**
+   * @brief Run next_async() on the scheduler and block until it finishes. Must not be called from
+   * a worker thread of the scheduler.
+   */
+  absl::StatusOr<std::shared_ptr<DataObject>> next() override {
+    return scheduler().run(next_async());
+  }
+};
+
+/**
+ * @brief co_await the next DataObject of any pipeline: next_async() of an AsyncDataPipeline, the
+ * plain next() of a synchronous one, which then runs on the awaiting thread.
+ */
+inline Task<absl::StatusOr<std::shared_ptr<DataObject>>> NextAsync(DataPipeline* pipeline) {
+  if (auto* async_pipeline = dynamic_cast<AsyncDataPipeline*>(pipeline)) {
+    co_return co_await async_pipeline->next_async();
+  }
+  co_return pipeline->next();
+}
+
+}  // namespace data_flow
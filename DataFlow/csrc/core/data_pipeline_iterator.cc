@@ -11,6 +11,8 @@
 #include "Python.h"
 
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 
 #include "glog/logging.h"
 #include "pybind11/pybind11.h"
@@ -25,13 +27,53 @@ using data_flow::DataPipeline;
 struct DataPipelineIterator {
   PyObject_HEAD;
   std::shared_ptr<DataPipeline> data_pipeline;
+  // 同一 pipeline 的所有迭代器共享，见 GetNextMutex
+  std::shared_ptr<std::mutex> next_mutex;
 };
 
+/**
+ * @brief Mutex held by the iterators of pipeline around next(), which runs without the GIL, so that
+ * Python threads sharing a pipeline call its next() one at a time. Only the pipeline being iterated
+ * is serialized: iterating a pipeline and one of its inputs from different threads is not safe.
+ * The mutex lives as long as an iterator of pipeline does.
+ */
+std::shared_ptr<std::mutex> GetNextMutex(const DataPipeline* pipeline) {
+  static std::mutex table_mutex;
+  static auto* table = new std::unordered_map<const DataPipeline*, std::weak_ptr<std::mutex>>();
+
+  std::lock_guard<std::mutex> lock(table_mutex);
+  auto& entry = (*table)[pipeline];
+  if (auto next_mutex = entry.lock()) {
+    return next_mutex;
+  }
+  std::shared_ptr<std::mutex> next_mutex(new std::mutex(), [pipeline](std::mutex* next_mutex) {
+    delete next_mutex;
+    std::lock_guard<std::mutex> lock(table_mutex);
+    // 地址可能已被新的 pipeline 复用并登记了新的 mutex
+    if (auto it = table->find(pipeline); it != table->end() && it->second.expired()) {
+      table->erase(it);
+    }
+  });
+  entry = next_mutex;
+  return next_mutex;
+}
+
 /**
  * @brief Retrieve the next item from the DataPipeline iterator.
  */
 PyObject* DataPipelineIterator_next(DataPipelineIterator* self) {
-  auto status_or_obj = self->data_pipeline->next();
+  absl::StatusOr<std::shared_ptr<data_flow::DataObject>> status_or_obj;
+  // next() 可能阻塞在 I/O 上(例如流式数据源)，期间释放 GIL，不阻塞其他 Python 线程；
+  // 释放 GIL 后由 pipeline 的锁保证多个线程不会同时调用 next()
+  Py_BEGIN_ALLOW_THREADS;
+  try {
+    std::lock_guard<std::mutex> lock(*self->next_mutex);
+    status_or_obj = self->data_pipeline->next();
+  } catch (const std::exception& e) {
+    status_or_obj = absl::InternalError(e.what());
+  }
+  Py_END_ALLOW_THREADS;
+
   if (!status_or_obj.ok()) {
     PyErr_SetString(PyExc_RuntimeError, status_or_obj.status().message().data());
     return nullptr;
@@ -58,6 +100,7 @@ PyTypeObject* GetIterType() {
         [](PyObject* self) -> void {
           auto iter = reinterpret_cast<DataPipelineIterator*>(self);
           iter->data_pipeline.~shared_ptr();
+          iter->next_mutex.~shared_ptr();
           Py_TYPE(self)->tp_free(self);
         },                                             /* tp_dealloc */
         0,                                             /* tp_vectorcall_offset */
@@ -142,6 +185,7 @@ PyObject* GetDataPipelineIterator(std::shared_ptr<DataPipeline> pipeline) {
 
   auto p = reinterpret_cast<DataPipelineIterator*>(iter);
   p->data_pipeline = pipeline;
+  p->next_mutex = GetNextMutex(pipeline.get());
   VLOG(5) << "DataPipelineIterator initialized with DataPipeline";
 
   return iter;
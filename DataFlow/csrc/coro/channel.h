@@ -0,0 +1,158 @@
+/**
+ * @file channel.h
+ * @brief Definition of Channel<T>, a bounded queue between coroutines.
+ *
+ * Author: Jasmine (1011694931@qq.com)
+ * Created on: 2025-11-18
+ *
+ * Copyright (c) 2025 Jasmine. All rights reserved.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <coroutine>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+#include "DataFlow/csrc/coro/scheduler.h"
+
+namespace data_flow {
+
+/**
+ * @brief Channel<T> is a bounded multi-producer multi-consumer queue. co_await push() suspends
+ * while the channel is full and co_await pop() while it is empty; suspended coroutines are
+ * resumed on the scheduler's workers. After close(), push() returns false and pop() drains the
+ * remaining items, then returns std::nullopt.
+ */
+template <typename T>
+class Channel {
+ public:
+  class PushAwaiter {
+   public:
+    PushAwaiter(Channel* channel, T value) : channel_(channel), value_(std::move(value)) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> handle) {
+      std::lock_guard<std::mutex> lock(channel_->mutex_);
+      if (channel_->closed_) {
+        return false;
+      }
+      if (!channel_->poppers_.empty()) {
+        // 直接交给等待中的消费者
+        auto* popper = channel_->poppers_.front();
+        channel_->poppers_.pop_front();
+        popper->item_.emplace(std::move(value_));
+        channel_->scheduler_->post(popper->handle_);
+        pushed_ = true;
+        return false;
+      }
+      if (channel_->items_.size() < channel_->capacity_) {
+        channel_->items_.push_back(std::move(value_));
+        pushed_ = true;
+        return false;
+      }
+      handle_ = handle;
+      channel_->pushers_.push_back(this);
+      return true;
+    }
+
+    bool await_resume() const noexcept { return pushed_; }
+
+   private:
+    friend class Channel;
+
+    Channel* channel_;
+    T value_;
+    std::coroutine_handle<> handle_;
+    bool pushed_ = false;
+  };
+
+  class PopAwaiter {
+   public:
+    explicit PopAwaiter(Channel* channel) : channel_(channel) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> handle) {
+      std::lock_guard<std::mutex> lock(channel_->mutex_);
+      if (!channel_->items_.empty()) {
+        item_.emplace(std::move(channel_->items_.front()));
+        channel_->items_.pop_front();
+        channel_->admit_pusher();
+        return false;
+      }
+      if (channel_->closed_) {
+        return false;
+      }
+      handle_ = handle;
+      channel_->poppers_.push_back(this);
+      return true;
+    }
+
+    std::optional<T> await_resume() { return std::move(item_); }
+
+   private:
+    friend class Channel;
+
+    Channel* channel_;
+    std::optional<T> item_;
+    std::coroutine_handle<> handle_;
+  };
+
+  Channel(Scheduler* scheduler, size_t capacity)
+      : scheduler_(scheduler), capacity_(std::max<size_t>(capacity, 1)) {}
+
+  Channel(const Channel&) = delete;
+  Channel& operator=(const Channel&) = delete;
+
+  PushAwaiter push(T value) { return PushAwaiter(this, std::move(value)); }
+
+  PopAwaiter pop() { return PopAwaiter(this); }
+
+  /**
+   * @brief Close the channel, resuming every waiting producer (push returns false) and consumer
+   * (pop returns std::nullopt).
+   */
+  void close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    for (auto* pusher : pushers_) {
+      scheduler_->post(pusher->handle_);
+    }
+    pushers_.clear();
+    for (auto* popper : poppers_) {
+      scheduler_->post(popper->handle_);
+    }
+    poppers_.clear();
+  }
+
+ private:
+  /**
+   * @brief Move the item of the first waiting producer into the slot freed by a pop.
+   */
+  void admit_pusher() {
+    if (pushers_.empty()) {
+      return;
+    }
+    auto* pusher = pushers_.front();
+    pushers_.pop_front();
+    items_.push_back(std::move(pusher->value_));
+    pusher->pushed_ = true;
+    scheduler_->post(pusher->handle_);
+  }
+
+  Scheduler* scheduler_;
+  size_t capacity_;
+  std::mutex mutex_;
+  std::deque<T> items_;
+  bool closed_ = false;
+  // 挂起的 awaiter 位于各自的协程帧中，恢复前一直有效
+  std::deque<PushAwaiter*> pushers_;
+  std::deque<PopAwaiter*> poppers_;
+};
+
+}  // namespace data_flow
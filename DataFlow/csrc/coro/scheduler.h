@@ -0,0 +1,400 @@
+/**
+ * @file scheduler.h
+ * @brief Definition of Scheduler, a fixed pool of worker threads running coroutines plus an epoll
+ * thread resuming the coroutines waiting for I/O.
+ *
+ * Author: Jasmine (1011694931@qq.com)
+ * Created on: 2025-11-18
+ *
+ * Copyright (c) 2025 Jasmine. All rights reserved.
+ */
+
+#pragma once
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_format.h"
+#include "glog/logging.h"
+
+#include "DataFlow/csrc/common/threads.h"
+#include "DataFlow/csrc/coro/task.h"
+
+namespace data_flow {
+
+/**
+ * @brief Scheduler runs many coroutines on num_threads worker threads. A coroutine waiting for a
+ * descriptor (co_await readable(fd)) is parked in epoll by the I/O thread and handed back to a
+ * worker once the descriptor is readable, its timeout expires or cancel_waits() is called, so a
+ * slow stream holds no thread while it waits.
+ *
+ * The scheduler must outlive every coroutine it runs. Only one coroutine may wait on a given
+ * descriptor at a time.
+ */
+class Scheduler {
+ public:
+  explicit Scheduler(size_t num_threads) {
+    epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+    wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    CHECK(epoll_fd_ >= 0 && wake_fd_ >= 0) << "Failed to create epoll: " << std::strerror(errno);
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = kWakeId;  // 唤醒 I/O 线程：退出或重新计算最近的超时
+    CHECK_EQ(::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &event), 0);
+
+    io_thread_ = Threads::Start([this] { io_loop(); });
+    num_threads = std::max<size_t>(num_threads, 1);
+    workers_.reserve(num_threads);
+    for (size_t i = 0; i < num_threads; ++i) {
+      workers_.push_back(Threads::Start([this] { work_loop(); }));
+    }
+  }
+
+  ~Scheduler() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    {
+      std::lock_guard<std::mutex> lock(waits_mutex_);
+      io_stop_ = true;
+    }
+    wake_io_thread();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+    io_thread_.join();
+    ::close(wake_fd_);
+    ::close(epoll_fd_);
+  }
+
+  Scheduler(const Scheduler&) = delete;
+  Scheduler& operator=(const Scheduler&) = delete;
+
+  /**
+   * @brief Number of worker threads; the I/O thread comes on top.
+   */
+  size_t num_threads() const { return workers_.size(); }
+
+  /**
+   * @brief Queue a suspended coroutine to be resumed by a worker.
+   */
+  void post(std::coroutine_handle<> handle) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ready_.push_back(handle);
+    }
+    cv_.notify_one();
+  }
+
+  /**
+   * @brief co_await schedule() continues the coroutine on a worker thread.
+   */
+  auto schedule() {
+    struct Awaiter {
+      bool await_ready() const noexcept { return false; }
+      void await_suspend(std::coroutine_handle<> handle) { scheduler->post(handle); }
+      void await_resume() const noexcept {}
+
+      Scheduler* scheduler;
+    };
+    return Awaiter{this};
+  }
+
+  /**
+   * @brief co_await readable(fd, timeout_ms) suspends until fd is readable (or hung up) and
+   * continues on a worker thread. Regular files, which epoll does not support, are always
+   * readable.
+   * @return DeadlineExceeded if fd stays unreadable for timeout_ms milliseconds (-1 waits
+   * forever), Cancelled once cancel_waits() has been called.
+   */
+  auto readable(int fd, int64_t timeout_ms = -1) {
+    struct Awaiter {
+      bool await_ready() const noexcept { return false; }
+
+      bool await_suspend(std::coroutine_handle<> handle) {
+        wait.handle = handle;
+        // 返回 true 后协程可能已在其他线程恢复，不能再访问 awaiter
+        return scheduler->park(fd, timeout_ms, &wait);
+      }
+
+      absl::Status await_resume() const { return wait.status; }
+
+      Scheduler* scheduler;
+      int fd;
+      int64_t timeout_ms;
+      Wait wait;
+    };
+    return Awaiter{this, fd, timeout_ms, {}};
+  }
+
+  /**
+   * @brief Resume every coroutine waiting in readable() with Cancelled, and make later waits fail
+   * the same way at once. Used to shut down coroutines parked on descriptors that may never become
+   * readable, e.g. an idle FIFO.
+   */
+  void cancel_waits() {
+    std::vector<std::coroutine_handle<>> resumed;
+    {
+      std::lock_guard<std::mutex> lock(waits_mutex_);
+      cancelled_ = true;
+      while (!waits_.empty()) {
+        resume_locked(waits_.begin()->first, absl::CancelledError("Scheduler wait cancelled"),
+                      &resumed);
+      }
+    }
+    for (auto handle : resumed) {
+      post(handle);
+    }
+  }
+
+  /**
+   * @brief Start a task on a worker thread without waiting for it. The task must not throw.
+   */
+  void spawn(Task<void> task) { Start(this, std::move(task)); }
+
+  /**
+   * @brief Run a task on the workers and block the calling thread until it finishes. Must not be
+   * called from a worker thread.
+   */
+  template <typename T>
+  T run(Task<T> task) {
+    RunState<T> state;
+    spawn(Complete(std::move(task), &state));
+    std::unique_lock<std::mutex> lock(state.mutex);
+    state.cv.wait(lock, [&] { return state.done; });
+    if (state.exception) {
+      std::rethrow_exception(state.exception);
+    }
+    if constexpr (!std::is_void_v<T>) {
+      return std::move(*state.value);
+    }
+  }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+  static constexpr uint64_t kWakeId = 0;
+
+  /**
+   * @brief A coroutine parked in readable(), registered in epoll under its id. Lives in the
+   * awaiter, i.e. in the frame of the waiting coroutine.
+   */
+  struct Wait {
+    std::coroutine_handle<> handle;
+    std::optional<Clock::time_point> deadline;
+    absl::Status status;
+  };
+
+  struct Detached {
+    struct promise_type {
+      Detached get_return_object() noexcept { return {}; }
+      std::suspend_never initial_suspend() const noexcept { return {}; }
+      std::suspend_never final_suspend() const noexcept { return {}; }
+      void return_void() noexcept {}
+      void unhandled_exception() noexcept {
+        LOG(FATAL) << "[Scheduler] exception escaped a spawned task";
+      }
+    };
+  };
+
+  template <typename T>
+  struct RunState {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool done = false;
+    std::optional<std::conditional_t<std::is_void_v<T>, bool, T>> value;
+    std::exception_ptr exception;
+  };
+
+  static Detached Start(Scheduler* scheduler, Task<void> task) {
+    co_await scheduler->schedule();
+    co_await std::move(task);
+  }
+
+  template <typename T>
+  static Task<void> Complete(Task<T> task, RunState<T>* state) {
+    try {
+      // task 的协程帧须在通知 run() 之前销毁
+      Task<T> awaited = std::move(task);
+      if constexpr (std::is_void_v<T>) {
+        co_await std::move(awaited);
+      } else {
+        state->value.emplace(co_await std::move(awaited));
+      }
+    } catch (...) {
+      state->exception = std::current_exception();
+    }
+    // 持锁通知：run() 返回后 state 即被销毁
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->done = true;
+    state->cv.notify_one();
+  }
+
+  void work_loop() {
+    while (true) {
+      std::coroutine_handle<> handle;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [&] { return stop_ || !ready_.empty(); });
+        if (ready_.empty()) {
+          return;
+        }
+        handle = ready_.front();
+        ready_.pop_front();
+      }
+      handle.resume();
+    }
+  }
+
+  void wake_io_thread() {
+    uint64_t one = 1;
+    (void)::write(wake_fd_, &one, sizeof(one));
+  }
+
+  /**
+   * @brief Register a wait in epoll, and in deadlines_ if it has a timeout.
+   * @return false if the coroutine continues at once, wait->status then holds the result.
+   */
+  bool park(int fd, int64_t timeout_ms, Wait* wait) {
+    std::lock_guard<std::mutex> lock(waits_mutex_);
+    if (cancelled_) {
+      wait->status = absl::CancelledError("Scheduler wait cancelled");
+      return false;
+    }
+    const uint64_t id = ++last_wait_id_;
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+    event.data.u64 = id;
+    // EPOLLONESHOT 触发后描述符仍在 epoll 中，再次等待时用 MOD 重新启用
+    int rc = ::epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &event);
+    if (rc != 0 && errno == ENOENT) {
+      rc = ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event);
+    }
+    if (rc != 0 && errno == EPERM) {
+      wait->status = absl::OkStatus();
+      return false;
+    }
+    if (rc != 0) {
+      wait->status = absl::InternalError(
+          absl::StrFormat("Failed to wait for fd %d: %s", fd, std::strerror(errno)));
+      return false;
+    }
+    // 持锁注册：I/O 线程处理该 id 的事件前 waits_ 中已有记录
+    waits_.emplace(id, wait);
+    if (timeout_ms >= 0) {
+      wait->deadline = Clock::now() + std::chrono::milliseconds(timeout_ms);
+      auto it = deadlines_.emplace(*wait->deadline, id).first;
+      if (it == deadlines_.begin()) {
+        wake_io_thread();
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Complete the wait with status. A wait completes once: the first of its event, its
+   * timeout and cancel_waits() removes it, later events of the same id are ignored.
+   */
+  void resume_locked(uint64_t id, absl::Status status,
+                     std::vector<std::coroutine_handle<>>* resumed) {
+    auto it = waits_.find(id);
+    if (it == waits_.end()) {
+      return;
+    }
+    Wait* wait = it->second;
+    waits_.erase(it);
+    if (wait->deadline.has_value()) {
+      deadlines_.erase({*wait->deadline, id});
+    }
+    wait->status = std::move(status);
+    resumed->push_back(wait->handle);
+  }
+
+  /**
+   * @brief epoll_wait timeout until the nearest deadline, -1 if there is none.
+   */
+  int io_timeout_ms() {
+    std::lock_guard<std::mutex> lock(waits_mutex_);
+    if (deadlines_.empty()) {
+      return -1;
+    }
+    auto wait = deadlines_.begin()->first - Clock::now();
+    // 向上取整，避免在到期前反复以 0 超时空转
+    return std::max<int64_t>(std::chrono::ceil<std::chrono::milliseconds>(wait).count(), 0);
+  }
+
+  void io_loop() {
+    epoll_event events[256];
+    std::vector<std::coroutine_handle<>> resumed;
+    while (true) {
+      int n = ::epoll_wait(epoll_fd_, events, 256, io_timeout_ms());
+      if (n < 0) {
+        CHECK_EQ(errno, EINTR) << "epoll_wait failed: " << std::strerror(errno);
+        continue;
+      }
+      {
+        std::lock_guard<std::mutex> lock(waits_mutex_);
+        if (io_stop_) {
+          return;
+        }
+        for (int i = 0; i < n; ++i) {
+          if (events[i].data.u64 == kWakeId) {
+            uint64_t count;
+            (void)::read(wake_fd_, &count, sizeof(count));
+            continue;
+          }
+          resume_locked(events[i].data.u64, absl::OkStatus(), &resumed);
+        }
+        const auto now = Clock::now();
+        while (!deadlines_.empty() && deadlines_.begin()->first <= now) {
+          resume_locked(deadlines_.begin()->second,
+                        absl::DeadlineExceededError("Scheduler wait timed out"), &resumed);
+        }
+      }
+      for (auto handle : resumed) {
+        post(handle);
+      }
+      resumed.clear();
+    }
+  }
+
+  int epoll_fd_ = -1;
+  int wake_fd_ = -1;
+  std::thread io_thread_;
+  std::vector<std::thread> workers_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::coroutine_handle<>> ready_;
+  bool stop_ = false;
+
+  // 等待 readable() 的协程，按 id 索引；deadlines_ 为其中带超时的部分
+  std::mutex waits_mutex_;
+  std::unordered_map<uint64_t, Wait*> waits_;
+  std::set<std::pair<Clock::time_point, uint64_t>> deadlines_;
+  uint64_t last_wait_id_ = kWakeId;
+  bool cancelled_ = false;
+  bool io_stop_ = false;
+};
+
+}  // namespace data_flow
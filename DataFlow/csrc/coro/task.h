@@ -0,0 +1,157 @@
+/**
+ * @file task.h
+ * @brief Definition of Task<T>, a lazily started C++20 coroutine returning T.
+ *
+ * Author: Jasmine (1011694931@qq.com)
+ * Created on: 2025-11-18
+ *
+ * Copyright (c) 2025 Jasmine. All rights reserved.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace data_flow {
+
+template <typename T>
+class Task;
+
+namespace internal {
+
+/**
+ * @brief Resumes the awaiting coroutine when a Task finishes, unless the Task finished before its
+ * awaiter suspended; the awaiter then simply continues. This keeps a loop of co_await on tasks
+ * that complete synchronously from growing the stack, without relying on tail calls.
+ */
+struct FinalAwaiter {
+  bool await_ready() const noexcept { return false; }
+
+  template <typename Promise>
+  void await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+    auto& promise = handle.promise();
+    std::coroutine_handle<> continuation = promise.continuation;
+    if (promise.finished.exchange(true, std::memory_order_acq_rel)) {
+      continuation.resume();
+    }
+  }
+
+  void await_resume() const noexcept {}
+};
+
+struct TaskPromiseBase {
+  std::suspend_always initial_suspend() const noexcept { return {}; }
+  FinalAwaiter final_suspend() const noexcept { return {}; }
+  void unhandled_exception() noexcept { exception = std::current_exception(); }
+
+  std::coroutine_handle<> continuation;
+  std::exception_ptr exception;
+  // 任务结束与 awaiter 挂起谁先发生，后到的一方负责恢复 awaiter
+  std::atomic<bool> finished{false};
+};
+
+template <typename T>
+struct TaskPromise final : TaskPromiseBase {
+  Task<T> get_return_object() noexcept;
+
+  template <typename U>
+  void return_value(U&& value) {
+    result.emplace(std::forward<U>(value));
+  }
+
+  T take() {
+    if (exception) {
+      std::rethrow_exception(exception);
+    }
+    return std::move(*result);
+  }
+
+  std::optional<T> result;
+};
+
+template <>
+struct TaskPromise<void> final : TaskPromiseBase {
+  Task<void> get_return_object() noexcept;
+
+  void return_void() noexcept {}
+
+  void take() {
+    if (exception) {
+      std::rethrow_exception(exception);
+    }
+  }
+};
+
+}  // namespace internal
+
+/**
+ * @brief Task<T> is a coroutine that starts when it is awaited and resumes its awaiter when it
+ * finishes. Exceptions thrown inside are rethrown from co_await. A Task owns its coroutine frame
+ * and can be awaited once.
+ */
+template <typename T = void>
+class [[nodiscard]] Task {
+ public:
+  using promise_type = internal::TaskPromise<T>;
+  using Handle = std::coroutine_handle<promise_type>;
+
+  explicit Task(Handle handle) : handle_(handle) {}
+  Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+  Task& operator=(Task&& other) noexcept {
+    if (this != &other) {
+      destroy();
+      handle_ = std::exchange(other.handle_, nullptr);
+    }
+    return *this;
+  }
+  Task(const Task&) = delete;
+  Task& operator=(const Task&) = delete;
+
+  ~Task() { destroy(); }
+
+  auto operator co_await() && noexcept {
+    struct Awaiter {
+      bool await_ready() const noexcept { return false; }
+
+      bool await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        auto& promise = handle.promise();
+        promise.continuation = awaiting;
+        handle.resume();
+        return !promise.finished.exchange(true, std::memory_order_acq_rel);
+      }
+
+      T await_resume() { return handle.promise().take(); }
+
+      Handle handle;
+    };
+    return Awaiter{handle_};
+  }
+
+ private:
+  void destroy() {
+    if (handle_) {
+      handle_.destroy();
+    }
+  }
+
+  Handle handle_;
+};
+
+namespace internal {
+
+template <typename T>
+Task<T> TaskPromise<T>::get_return_object() noexcept {
+  return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() noexcept {
+  return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+}  // namespace internal
+
+}  // namespace data_flow
@@ -10,7 +10,6 @@
 
 #pragma once
 
-#include <cstdio>
 #include <cstring>
 #include <memory>
 #include <span>
@@ -18,6 +17,10 @@
 #include "glog/logging.h"
 
 #include "DataFlow/csrc/core/data_object.h"
+#include "DataFlow/csrc/coro/scheduler.h"
+#include "DataFlow/csrc/io/file_system_registry.h"
+#include "DataFlow/csrc/io/readahead_reader.h"
+#include "DataFlow/csrc/io/stream_file.h"
 
 namespace data_flow {
 // Forward declaration
@@ -27,28 +30,50 @@ class ByteStream;
 using ByteStreamMeta = DataMeta<ByteStream>;
 
 /**
- * @brief Stream is a data object that provides chunked access to a file stream.
+ * @brief Stream is a data object that provides chunked access to a file stream. It reads a file of
+ * FileSystemRegistry (a local path or "file://" uri) sequentially, a StreamFile (FIFO, Unix domain
+ * socket, stdin) or a remote file through a ReadaheadReader.
  */
 class ByteStream final : public DataObject {
  public:
+  /**
+   * @brief Open file_name with FileSystemRegistry and read it sequentially.
+   */
   ByteStream(std::string&& file_name, size_t buffer_size = 4096)
-      : file_name_(std::move(file_name)),
+      : ByteStream(OpenOrThrow(file_name), buffer_size) {}
+
+  ByteStream(std::unique_ptr<RandomAccessFile> file, size_t buffer_size)
+      : file_(std::move(file)),
         buffer_size_(buffer_size),
         buffer_(new char[buffer_size]),
         pos_(0),
-        end_(0) {
-    local_file_ = std::fopen(file_name_.data(), "rb");
-    if (!local_file_) {
-      LOG(ERROR) << "Failed to open file: " << file_name_;
-      throw std::runtime_error(absl::StrFormat("Failed to open file: %s", file_name_));
+        end_(0),
+        file_name_(file_->uri()) {
+    try {
+      refill_buffer();
+    } catch (...) {
+      delete[] buffer_;
+      throw;
     }
-    refill_buffer();
   }
 
+  ByteStream(std::unique_ptr<StreamFile> stream_file, size_t buffer_size)
+      : stream_file_(std::move(stream_file)),
+        buffer_size_(buffer_size),
+        buffer_(new char[buffer_size]),
+        pos_(0),
+        end_(0),
+        file_name_(stream_file_->uri()) {}
+
+  ByteStream(std::unique_ptr<ReadaheadReader> readahead_reader, size_t buffer_size)
+      : readahead_reader_(std::move(readahead_reader)),
+        buffer_size_(buffer_size),
+        buffer_(new char[buffer_size]),
+        pos_(0),
+        end_(0),
+        file_name_(readahead_reader_->uri()) {}
+
   ~ByteStream() final {
-    if (local_file_) {
-      std::fclose(local_file_);
-    }
     delete[] buffer_;
     VLOG(1) << "[ByteStream] destructor";
   }
@@ -78,15 +103,86 @@ class ByteStream final : public DataObject {
     return chunk;
   }
 
-  bool eof() const { return pos_ >= end_ && std::feof(local_file_); }
+  /**
+   * @brief Asynchronous read_chunk(): a coroutine reading a stream or a remote file is suspended
+   * on the scheduler until data arrives, instead of blocking its thread. Files of
+   * FileSystemRegistry are read in place, local page cache reads do not wait.
+   */
+  Task<std::span<const char>> read_chunk_async(Scheduler& scheduler) {
+    if (pos_ == end_) {
+      co_await refill_buffer_async(scheduler);
+    }
+
+    std::span<const char> chunk(buffer_ + pos_, end_ - pos_);
+    pos_ = end_;
+    co_return chunk;
+  }
+
+  bool eof() const { return pos_ >= end_ && stream_eof_; }
 
  private:
+  static std::unique_ptr<RandomAccessFile> OpenOrThrow(const std::string& file_name) {
+    auto status_or_file = FileSystemRegistry::Instance().open(file_name);
+    if (!status_or_file.ok()) {
+      LOG(ERROR) << "Failed to open file: " << file_name;
+      throw std::runtime_error(std::string(status_or_file.status().message()));
+    }
+    return std::move(status_or_file).value();
+  }
+
   void refill_buffer() {
     pos_ = 0;
-    end_ = std::fread(buffer_, 1, buffer_size_, local_file_);
+    absl::StatusOr<size_t> status_or_size;
+    if (file_) {
+      status_or_size = file_->read(offset_, buffer_size_, buffer_);
+    } else if (stream_file_) {
+      status_or_size = stream_file_->read(buffer_, buffer_size_);
+    } else {
+      status_or_size = readahead_reader_->read(buffer_, buffer_size_);
+    }
+    if (!status_or_size.ok()) {
+      end_ = 0;
+      stream_eof_ = true;
+      throw std::runtime_error(std::string(status_or_size.status().message()));
+    }
+    end_ = status_or_size.value();
+    if (file_) {
+      // RandomAccessFile::read 只在文件末尾返回少于请求的字节数
+      offset_ += end_;
+      stream_eof_ = end_ < buffer_size_;
+    } else {
+      stream_eof_ = end_ == 0;
+    }
+  }
+
+  Task<void> refill_buffer_async(Scheduler& scheduler) {
+    if (file_) {
+      refill_buffer();
+      co_return;
+    }
+
+    pos_ = 0;
+    absl::StatusOr<size_t> status_or_size;
+    if (stream_file_) {
+      status_or_size = co_await stream_file_->read_async(scheduler, buffer_, buffer_size_);
+    } else {
+      status_or_size = co_await readahead_reader_->read_async(scheduler, buffer_, buffer_size_);
+    }
+    if (!status_or_size.ok()) {
+      end_ = 0;
+      stream_eof_ = true;
+      throw std::runtime_error(std::string(status_or_size.status().message()));
+    }
+    end_ = status_or_size.value();
+    stream_eof_ = end_ == 0;
   }
 
-  FILE* local_file_;
+  // 三种来源只有一个非空
+  std::unique_ptr<RandomAccessFile> file_;
+  uint64_t offset_ = 0;
+  std::unique_ptr<StreamFile> stream_file_;
+  std::unique_ptr<ReadaheadReader> readahead_reader_;
+  bool stream_eof_ = false;
   size_t buffer_size_;
   char* buffer_;
   size_t pos_;
@@ -57,9 +57,65 @@ class InflateStream final : public DataObject {
    * @return A span representing the decompressed data chunk.
    */
   std::span<const char> read_chunk(size_t size) {
-    if (end_of_stream_) {
+    if (!begin_chunk(size)) {
       return std::span<const char>{};
     }
+    // 持续解压直到获得足够的数据或到达流末尾
+    while (!chunk_full()) {
+      if (z_stream_.avail_in == 0 && !end_of_stream_) {
+        // 获取新的压缩数据
+        set_input(compressed_stream_->read_chunk());
+        if (end_of_stream_) {
+          break;
+        }
+      }
+      if (inflate_input()) {
+        break;
+      }
+    }
+    return output();
+  }
+
+  /**
+   * @brief Asynchronous read_chunk(): awaits compressed data with ByteStream::read_chunk_async, so
+   * a coroutine waiting for a slow stream holds no thread.
+   */
+  Task<std::span<const char>> read_chunk_async(Scheduler& scheduler, size_t size) {
+    if (!begin_chunk(size)) {
+      co_return std::span<const char>{};
+    }
+    while (!chunk_full()) {
+      if (z_stream_.avail_in == 0 && !end_of_stream_) {
+        set_input(co_await compressed_stream_->read_chunk_async(scheduler));
+        if (end_of_stream_) {
+          break;
+        }
+      }
+      if (inflate_input()) {
+        break;
+      }
+    }
+    co_return output();
+  }
+
+ private:
+  // 自动判断输入的格式
+  static constexpr int32_t kFormatAutomatic = 32;
+  static constexpr int32_t kMaxWindowSize = 15;
+  void inflate_stream_init() {
+    z_stream_ = {};
+    CHECK_EQ(inflateInit2(&z_stream_, kFormatAutomatic | kMaxWindowSize), Z_OK)
+        << "Failed to initialize zlib inflate stream";
+  }
+
+  /**
+   * @brief Point the zlib output at a buffer of size bytes.
+   * @return false at the end of the stream.
+   */
+  bool begin_chunk(size_t size) {
+    if (end_of_stream_) {
+      return false;
+    }
 
     // 如果请求的大小为0，使用默认大小
     if (size == 0) {
@@ -75,55 +131,52 @@ class InflateStream final : public DataObject {
     CHECK_LT(size, INT_MAX) << "Requested chunk size exceeds INT_MAX";
 
     // set zlib output buffer
+    requested_size_ = size;
     z_stream_.avail_out = size;
     z_stream_.next_out = reinterpret_cast<Bytef*>(output_chunk_.get());
+    return true;
+  }
 
-    // 持续解压直到获得足够的数据或到达流末尾
-    while ((z_stream_.next_out - reinterpret_cast<Bytef*>(output_chunk_.get())) < size) {
-      if (z_stream_.avail_in == 0 && !end_of_stream_) {
-        // 获取新的压缩数据
-        auto input_chunk = compressed_stream_->read_chunk();
-        if (!input_chunk.empty()) {
-          // 设置输入数据
-          z_stream_.avail_in = input_chunk.size();
-          z_stream_.next_in =
-              const_cast<Bytef*>(reinterpret_cast<const Bytef*>(input_chunk.data()));
-        } else {
-          end_of_stream_ = true;
-          break;
-        }
-      }
-      // 执行解压缩
-      int ret = inflate(&z_stream_, Z_NO_FLUSH);
-
-      VLOG(5) << "Decompressing: output_size="
-              << (z_stream_.next_out - reinterpret_cast<Bytef*>(output_chunk_.get()))
-              << ", want_size=" << size << ", avail_in=" << z_stream_.avail_in;
+  size_t output_size() const {
+    return z_stream_.next_out - reinterpret_cast<const Bytef*>(output_chunk_.get());
+  }
 
-      CHECK(ret == Z_OK || ret == Z_STREAM_END)
-          << "Inflation failed: " << ret << ", msg: " << z_stream_.msg;
+  bool chunk_full() const { return output_size() >= requested_size_; }
 
-      if (ret == Z_STREAM_END) {
-        end_of_stream_ = true;
-        break;
-      }
+  void set_input(std::span<const char> input_chunk) {
+    if (input_chunk.empty()) {
+      end_of_stream_ = true;
+      return;
     }
+    // 设置输入数据
+    z_stream_.avail_in = input_chunk.size();
+    z_stream_.next_in = const_cast<Bytef*>(reinterpret_cast<const Bytef*>(input_chunk.data()));
+  }
+
+  /**
+   * @brief Inflate the buffered input into the output buffer.
+   * @return true at the end of the compressed stream.
+   */
+  bool inflate_input() {
+    // 执行解压缩
+    int ret = inflate(&z_stream_, Z_NO_FLUSH);
+
+    VLOG(5) << "Decompressing: output_size=" << output_size() << ", want_size=" << requested_size_
+            << ", avail_in=" << z_stream_.avail_in;
 
-    // 计算实际解压的数据大小
-    size_t decompressed_size = z_stream_.next_out - reinterpret_cast<Bytef*>(output_chunk_.get());
+    CHECK(ret == Z_OK || ret == Z_STREAM_END)
+        << "Inflation failed: " << ret << ", msg: " << z_stream_.msg;
 
-    // 返回解压后数据的视图，实现零拷贝
-    return std::span<const char>(output_chunk_.get(), decompressed_size);
+    if (ret == Z_STREAM_END) {
+      end_of_stream_ = true;
+      return true;
+    }
+    return false;
   }
 
- private:
-  // 自动判断输入的格式
-  static constexpr int32_t kFormatAutomatic = 32;
-  static constexpr int32_t kMaxWindowSize = 15;
-  void inflate_stream_init() {
-    z_stream_ = {};
-    CHECK_EQ(inflateInit2(&z_stream_, kFormatAutomatic | kMaxWindowSize), Z_OK)
-        << "Failed to initialize zlib inflate stream";
+  // 返回解压后数据的视图，实现零拷贝
+  std::span<const char> output() const {
+    return std::span<const char>(output_chunk_.get(), output_size());
   }
 
  private:
@@ -133,6 +186,7 @@ class InflateStream final : public DataObject {
 
   // output buffer
   size_t output_chunk_size_ = 0;
+  size_t requested_size_ = 0;
   std::unique_ptr<char[]> output_chunk_;
   bool end_of_stream_ = false;
 
@@ -0,0 +1,392 @@
+/**
+ * @file sample_batch.h
+ * @brief Definition of SampleBatch data object holding parsed samples in columnar layout.
+ *
+ * Author: Jasmine (1011694931@qq.com)
+ * Created on: 2025-11-8
+ *
+ * Copyright (c) 2025 Jasmine. All rights reserved.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+
+#include "DataFlow/csrc/core/data_object.h"
+
+namespace data_flow {
+// Forward declaration
+class SampleBatch;
+
+// Type alias for SampleBatch metadata
+using SampleBatchMeta = DataMeta<SampleBatch>;
+
+/**
+ * @brief Storage types of the ids of a sparse column, the values of a dense column and the labels
+ * of a SampleBatch. The compact types are chosen by TextSampleOptions and produced while parsing.
+ */
+enum class SparseIdDType : uint8_t { kUint64, kUint32 };
+enum class DenseDType : uint8_t { kFloat32, kFloat16, kBFloat16 };
+enum class LabelDType : uint8_t { kFloat32, kUint8 };
+
+/**
+ * @brief Parse a dtype from its numpy name: "uint64" or "uint32" for sparse ids, "float32",
+ * "float16" or "bfloat16" for dense values, "float32" or "uint8" for labels.
+ */
+inline absl::StatusOr<SparseIdDType> SparseIdDTypeFromName(std::string_view name) {
+  if (name == "uint64") return SparseIdDType::kUint64;
+  if (name == "uint32") return SparseIdDType::kUint32;
+  return absl::InvalidArgumentError(absl::StrFormat("Unknown sparse id dtype: %s", name));
+}
+
+inline absl::StatusOr<DenseDType> DenseDTypeFromName(std::string_view name) {
+  if (name == "float32") return DenseDType::kFloat32;
+  if (name == "float16") return DenseDType::kFloat16;
+  if (name == "bfloat16") return DenseDType::kBFloat16;
+  return absl::InvalidArgumentError(absl::StrFormat("Unknown dense dtype: %s", name));
+}
+
+inline absl::StatusOr<LabelDType> LabelDTypeFromName(std::string_view name) {
+  if (name == "float32") return LabelDType::kFloat32;
+  if (name == "uint8") return LabelDType::kUint8;
+  return absl::InvalidArgumentError(absl::StrFormat("Unknown label dtype: %s", name));
+}
+
+/**
+ * @brief SparseColumn stores the ids and weights of one sparse slot in CSR layout: the values of
+ * row i are ids[offsets[i], offsets[i + 1]). With id_dtype kUint32 the ids are stored in ids32 and
+ * ids is empty.
+ */
+struct SparseColumn {
+  int64_t slot = 0;
+  SparseIdDType id_dtype = SparseIdDType::kUint64;
+  std::vector<uint64_t> ids;
+  std::vector<uint32_t> ids32;
+  std::vector<float> weights;
+  std::vector<uint32_t> offsets{0};
+
+  // 去重结果(SparseDedup)：ids[i] == unique_ids[inverse[i]]，
+  // 全局去重时 unique_ids 为空，inverse 指向 SampleBatch::unique_ids()
+  std::vector<uint64_t> unique_ids;
+  std::vector<uint32_t> inverse;
+
+  size_t rows() const { return offsets.size() - 1; }
+  size_t size() const { return id_dtype == SparseIdDType::kUint32 ? ids32.size() : ids.size(); }
+
+  /**
+   * @brief Resize ids and weights to n values.
+   */
+  void resize(size_t n) {
+    if (id_dtype == SparseIdDType::kUint32) {
+      ids32.resize(n);
+    } else {
+      ids.resize(n);
+    }
+    weights.resize(n);
+  }
+};
+
+/**
+ * @brief DenseColumn stores the values of one dense slot as a row-major [rows, width] matrix. With
+ * dtype kFloat16 or kBFloat16 the values are stored as 16-bit patterns in half_values and values
+ * is empty.
+ */
+struct DenseColumn {
+  int64_t slot = 0;
+  uint32_t width = 0;
+  DenseDType dtype = DenseDType::kFloat32;
+  std::vector<float> values;
+  std::vector<uint16_t> half_values;
+
+  size_t size() const { return dtype == DenseDType::kFloat32 ? values.size() : half_values.size(); }
+  size_t rows() const { return width == 0 ? 0 : size() / width; }
+
+  /**
+   * @brief Resize to n values, padding with zeros (0 is all zero bits in every dtype).
+   */
+  void resize(size_t n) {
+    if (dtype == DenseDType::kFloat32) {
+      values.resize(n, 0.0f);
+    } else {
+      half_values.resize(n, 0);
+    }
+  }
+};
+
+/**
+ * @brief SampleBatch is a data object holding a batch of parsed samples. Per-sample fields and
+ * every sparse/dense slot are stored as separate contiguous columns so that downstream stages can
+ * run over whole batches instead of individual samples.
+ */
+class SampleBatch final : public DataObject {
+ public:
+  SampleBatch() = default;
+  ~SampleBatch() final = default;
+
+  std::shared_ptr<DataObjectMeta> data_meta() const final {
+    static std::shared_ptr<DataObjectMeta> meta = std::make_shared<SampleBatchMeta>();
+    return meta;
+  }
+
+  void* ptr() final { return this; }
+
+  size_t rows() const { return timestamps_.size(); }
+
+  std::vector<std::string>& sample_ids() { return sample_ids_; }
+  const std::vector<std::string>& sample_ids() const { return sample_ids_; }
+
+  std::vector<uint64_t>& group_ids() { return group_ids_; }
+  const std::vector<uint64_t>& group_ids() const { return group_ids_; }
+
+  /**
+   * @brief Labels, stored in labels() or, with label_dtype kUint8, in labels_uint8().
+   */
+  LabelDType label_dtype() const { return label_dtype_; }
+  void set_label_dtype(LabelDType dtype) { label_dtype_ = dtype; }
+
+  std::vector<float>& labels() { return labels_; }
+  const std::vector<float>& labels() const { return labels_; }
+
+  std::vector<uint8_t>& labels_uint8() { return labels_uint8_; }
+  const std::vector<uint8_t>& labels_uint8() const { return labels_uint8_; }
+
+  std::vector<int64_t>& timestamps() { return timestamps_; }
+  const std::vector<int64_t>& timestamps() const { return timestamps_; }
+
+  /**
+   * @brief Row offsets of the groups of a grouped batch: rows [group_offsets[i],
+   * group_offsets[i + 1]) share the same group id. Empty if the batch is not grouped.
+   */
+  std::vector<uint32_t>& group_offsets() { return group_offsets_; }
+  const std::vector<uint32_t>& group_offsets() const { return group_offsets_; }
+
+  /**
+   * @brief Unique ids of all sparse columns, set by a global SparseDedup: the inverse of every
+   * sparse column then indexes into this list.
+   */
+  std::vector<uint64_t>& unique_ids() { return unique_ids_; }
+  const std::vector<uint64_t>& unique_ids() const { return unique_ids_; }
+
+  std::vector<SparseColumn>& sparse_columns() { return sparse_columns_; }
+  const std::vector<SparseColumn>& sparse_columns() const { return sparse_columns_; }
+
+  std::vector<DenseColumn>& dense_columns() { return dense_columns_; }
+  const std::vector<DenseColumn>& dense_columns() const { return dense_columns_; }
+
+  /**
+   * @brief Find the sparse column of the given slot.
+   * @return Pointer to the column, or nullptr if the slot is not present in this batch.
+   */
+  const SparseColumn* find_sparse(int64_t slot) const {
+    for (const auto& column : sparse_columns_) {
+      if (column.slot == slot) {
+        return &column;
+      }
+    }
+    return nullptr;
+  }
+
+  /**
+   * @brief Find the dense column of the given slot.
+   * @return Pointer to the column, or nullptr if the slot is not present in this batch.
+   */
+  const DenseColumn* find_dense(int64_t slot) const {
+    for (const auto& column : dense_columns_) {
+      if (column.slot == slot) {
+        return &column;
+      }
+    }
+    return nullptr;
+  }
+
+  /**
+   * @brief Copy the per-sample fields (sample id, group id, label, timestamp) of another batch.
+   */
+  void copy_sample_fields(const SampleBatch& other) {
+    sample_ids_ = other.sample_ids_;
+    group_ids_ = other.group_ids_;
+    label_dtype_ = other.label_dtype_;
+    labels_ = other.labels_;
+    labels_uint8_ = other.labels_uint8_;
+    timestamps_ = other.timestamps_;
+    group_offsets_ = other.group_offsets_;
+  }
+
+ private:
+  std::vector<std::string> sample_ids_;
+  std::vector<uint64_t> group_ids_;
+  LabelDType label_dtype_ = LabelDType::kFloat32;
+  std::vector<float> labels_;
+  std::vector<uint8_t> labels_uint8_;
+  std::vector<int64_t> timestamps_;
+  std::vector<uint32_t> group_offsets_;
+  std::vector<uint64_t> unique_ids_;
+
+  std::vector<SparseColumn> sparse_columns_;
+  std::vector<DenseColumn> dense_columns_;
+};
+
+/**
+ * @brief SampleBatchAppender copies single rows of other batches into an empty batch. Columns are
+ * matched by slot; a slot missing from a source row is appended as an empty sparse row or a zero
+ * dense row, and a slot seen for the first time is back-filled for the rows already appended.
+ *
+ * The column mapping of a source batch is computed the first time one of its rows is appended and
+ * kept, together with a reference to the batch, until the appender is destroyed, so rows of a few
+ * batches can be appended interleaved.
+ */
+class SampleBatchAppender {
+ public:
+  explicit SampleBatchAppender(SampleBatch* batch) : batch_(batch) {}
+
+  /**
+   * @brief Append row `row` of `src`.
+   * @return InvalidArgument if a dense slot of src has a different width than in the batch.
+   */
+  absl::Status append(const std::shared_ptr<const SampleBatch>& src, size_t row) {
+    if (src.get() != src_) {
+      auto it = column_maps_.find(src.get());
+      if (it == column_maps_.end()) {
+        auto status_or_it = map_columns(src);
+        if (!status_or_it.ok()) {
+          return status_or_it.status();
+        }
+        it = status_or_it.value();
+      }
+      src_ = src.get();
+      map_ = &it->second;
+    }
+
+    batch_->sample_ids().push_back(src->sample_ids()[row]);
+    batch_->group_ids().push_back(src->group_ids()[row]);
+    if (src->label_dtype() == LabelDType::kUint8) {
+      batch_->labels_uint8().push_back(src->labels_uint8()[row]);
+    } else {
+      batch_->labels().push_back(src->labels()[row]);
+    }
+    batch_->timestamps().push_back(src->timestamps()[row]);
+
+    auto& sparse_columns = batch_->sparse_columns();
+    for (size_t i = 0; i < src->sparse_columns().size(); ++i) {
+      const auto& from = src->sparse_columns()[i];
+      auto& to = sparse_columns[map_->sparse[i]];
+      const uint32_t begin = from.offsets[row], end = from.offsets[row + 1];
+      if (from.id_dtype == SparseIdDType::kUint32) {
+        to.ids32.insert(to.ids32.end(), from.ids32.begin() + begin, from.ids32.begin() + end);
+      } else {
+        to.ids.insert(to.ids.end(), from.ids.begin() + begin, from.ids.begin() + end);
+      }
+      to.weights.insert(to.weights.end(), from.weights.begin() + begin,
+                        from.weights.begin() + end);
+    }
+    for (auto& column : sparse_columns) {
+      column.offsets.push_back(column.size());
+    }
+
+    auto& dense_columns = batch_->dense_columns();
+    for (size_t i = 0; i < src->dense_columns().size(); ++i) {
+      const auto& from = src->dense_columns()[i];
+      if (from.width == 0) {
+        continue;  // slot 在源 batch 中不存在
+      }
+      auto& to = dense_columns[map_->dense[i]];
+      if (from.dtype == DenseDType::kFloat32) {
+        to.values.insert(to.values.end(), from.values.begin() + row * from.width,
+                         from.values.begin() + (row + 1) * from.width);
+      } else {
+        to.half_values.insert(to.half_values.end(), from.half_values.begin() + row * from.width,
+                              from.half_values.begin() + (row + 1) * from.width);
+      }
+    }
+    const size_t rows = batch_->rows();
+    for (auto& column : dense_columns) {
+      column.resize(rows * column.width);
+    }
+    return absl::OkStatus();
+  }
+
+ private:
+  struct ColumnMap {
+    // 持有源 batch，其地址在 appender 析构前不会被其他 batch 复用
+    std::shared_ptr<const SampleBatch> src;
+    // 源 batch 第 i 列在 batch_ 中的下标
+    std::vector<uint32_t> sparse;
+    std::vector<uint32_t> dense;
+  };
+
+  using ColumnMaps = absl::flat_hash_map<const SampleBatch*, ColumnMap>;
+
+  /**
+   * @brief Map the columns of src to columns of the batch, adding the slots it sees first.
+   */
+  absl::StatusOr<ColumnMaps::iterator> map_columns(const std::shared_ptr<const SampleBatch>& src) {
+    const size_t rows = batch_->rows();
+    if (rows == 0) {
+      batch_->set_label_dtype(src->label_dtype());
+    } else if (src->label_dtype() != batch_->label_dtype()) {
+      return absl::InvalidArgumentError("label dtype differs between batches");
+    }
+
+    ColumnMap map;
+    map.src = src;
+    auto& sparse_columns = batch_->sparse_columns();
+    for (const auto& column : src->sparse_columns()) {
+      auto [it, inserted] = sparse_index_.try_emplace(column.slot, sparse_columns.size());
+      if (inserted) {
+        SparseColumn to;
+        to.slot = column.slot;
+        to.id_dtype = column.id_dtype;
+        to.offsets.assign(rows + 1, 0);
+        sparse_columns.push_back(std::move(to));
+      } else if (sparse_columns[it->second].id_dtype != column.id_dtype) {
+        return absl::InvalidArgumentError(
+            absl::StrFormat("sparse slot %d has ids of different dtypes", column.slot));
+      }
+      map.sparse.push_back(it->second);
+    }
+
+    auto& dense_columns = batch_->dense_columns();
+    for (const auto& column : src->dense_columns()) {
+      auto [it, inserted] = dense_index_.try_emplace(column.slot, dense_columns.size());
+      if (inserted) {
+        DenseColumn to;
+        to.slot = column.slot;
+        dense_columns.push_back(std::move(to));
+      }
+      auto& to = dense_columns[it->second];
+      if (to.width == 0) {
+        // 宽度此前未知，之前的行补零
+        to.width = column.width;
+        to.dtype = column.dtype;
+        to.resize(rows * to.width);
+      } else if (column.width != 0 && column.width != to.width) {
+        return absl::InvalidArgumentError(absl::StrFormat(
+            "dense slot %d has width %d, expected %d", column.slot, column.width, to.width));
+      } else if (column.width != 0 && column.dtype != to.dtype) {
+        return absl::InvalidArgumentError(
+            absl::StrFormat("dense slot %d has values of different dtypes", column.slot));
+      }
+      map.dense.push_back(it->second);
+    }
+    return column_maps_.emplace(src.get(), std::move(map)).first;
+  }
+
+  SampleBatch* batch_;
+  absl::flat_hash_map<int64_t, uint32_t> sparse_index_;
+  absl::flat_hash_map<int64_t, uint32_t> dense_index_;
+  ColumnMaps column_maps_;
+  // 上一行的源 batch 及其列映射
+  const SampleBatch* src_ = nullptr;
+  const ColumnMap* map_ = nullptr;
+};
+
+}  // namespace data_flow
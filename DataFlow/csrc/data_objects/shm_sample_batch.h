@@ -0,0 +1,346 @@
+/**
+ * @file shm_sample_batch.h
+ * @brief Definition of ShmSampleBatch, a read-only SampleBatch stored in a slot of a ShmRing.
+ *
+ * Author: Jasmine (1011694931@qq.com)
+ * Created on: 2025-11-14
+ *
+ * Copyright (c) 2025 Jasmine. All rights reserved.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+
+#include "DataFlow/csrc/core/data_object.h"
+#include "DataFlow/csrc/data_objects/sample_batch.h"
+#include "DataFlow/csrc/ipc/shm_ring.h"
+
+namespace data_flow {
+// Forward declaration
+class ShmSampleBatch;
+
+// Type alias for ShmSampleBatch metadata
+using ShmSampleBatchMeta = DataMeta<ShmSampleBatch>;
+
+/**
+ * @brief View of a sparse column of a ShmSampleBatch, see SparseColumn.
+ */
+struct ShmSparseColumn {
+  int64_t slot = 0;
+  SparseIdDType id_dtype = SparseIdDType::kUint64;
+  std::span<const uint64_t> ids;
+  std::span<const uint32_t> ids32;
+  std::span<const float> weights;
+  std::span<const uint32_t> offsets;
+
+  // SparseDedup 的结果，见 SparseColumn
+  std::span<const uint64_t> unique_ids;
+  std::span<const uint32_t> inverse;
+
+  size_t size() const { return weights.size(); }
+};
+
+/**
+ * @brief View of a dense column of a ShmSampleBatch, see DenseColumn.
+ */
+struct ShmDenseColumn {
+  int64_t slot = 0;
+  uint32_t width = 0;
+  DenseDType dtype = DenseDType::kFloat32;
+  std::span<const float> values;
+  std::span<const uint16_t> half_values;
+};
+
+/**
+ * @brief ShmSampleBatch is a SampleBatch encoded by a worker process into a slot of a ShmRing and
+ * read in place by the consumer: columns are spans into the shared memory, nothing is copied. The
+ * slot goes back to the workers when the ShmSampleBatch is destroyed.
+ *
+ * Slot layout: a Header, a ColumnDesc per sparse then dense column, then the column arrays, each
+ * 64-byte aligned and addressed by its byte offset from the start of the slot.
+ */
+class ShmSampleBatch final : public DataObject {
+ public:
+  /**
+   * @brief Encode a batch into dst.
+   * @return Number of bytes written, or ResourceExhausted if the batch needs more than capacity.
+   */
+  static absl::StatusOr<size_t> Encode(const SampleBatch& batch, char* dst, size_t capacity) {
+    const size_t rows = batch.rows();
+    const size_t num_columns = batch.sparse_columns().size() + batch.dense_columns().size();
+    size_t sample_id_bytes = 0;
+    for (const auto& id : batch.sample_ids()) {
+      sample_id_bytes += id.size();
+    }
+
+    // 先计算总大小，再写入
+    size_t size = Align(sizeof(Header) + num_columns * sizeof(ColumnDesc));
+    auto reserve = [&size](size_t bytes) {
+      size_t offset = size;
+      size = Align(size + bytes);
+      return offset;
+    };
+    Header header{};
+    header.rows = rows;
+    header.num_sparse = batch.sparse_columns().size();
+    header.num_dense = batch.dense_columns().size();
+    header.num_group_offsets = batch.group_offsets().size();
+    header.label_dtype = static_cast<uint32_t>(batch.label_dtype());
+    header.group_ids = reserve(rows * sizeof(uint64_t));
+    header.labels = reserve(batch.label_dtype() == LabelDType::kUint8 ? rows * sizeof(uint8_t)
+                                                                       : rows * sizeof(float));
+    header.timestamps = reserve(rows * sizeof(int64_t));
+    header.group_offsets = reserve(header.num_group_offsets * sizeof(uint32_t));
+    header.sample_id_offsets = reserve((rows + 1) * sizeof(uint32_t));
+    header.sample_id_chars = reserve(sample_id_bytes);
+    header.num_unique_ids = batch.unique_ids().size();
+    header.unique_ids = reserve(header.num_unique_ids * sizeof(uint64_t));
+
+    std::vector<ColumnDesc> columns;
+    columns.reserve(num_columns);
+    for (const auto& column : batch.sparse_columns()) {
+      ColumnDesc desc{};
+      desc.slot = column.slot;
+      desc.dtype = static_cast<uint32_t>(column.id_dtype);
+      desc.size = column.size();
+      desc.values = reserve(column.ids.size() * sizeof(uint64_t) +
+                            column.ids32.size() * sizeof(uint32_t));
+      desc.weights = reserve(column.weights.size() * sizeof(float));
+      desc.offsets = reserve(column.offsets.size() * sizeof(uint32_t));
+      desc.num_unique_ids = column.unique_ids.size();
+      desc.unique_ids = reserve(desc.num_unique_ids * sizeof(uint64_t));
+      desc.num_inverse = column.inverse.size();
+      desc.inverse = reserve(desc.num_inverse * sizeof(uint32_t));
+      columns.push_back(desc);
+    }
+    for (const auto& column : batch.dense_columns()) {
+      ColumnDesc desc{};
+      desc.slot = column.slot;
+      desc.dtype = static_cast<uint32_t>(column.dtype);
+      desc.size = column.width;
+      desc.values = reserve(column.values.size() * sizeof(float) +
+                            column.half_values.size() * sizeof(uint16_t));
+      columns.push_back(desc);
+    }
+    if (size > capacity) {
+      return absl::ResourceExhaustedError(absl::StrFormat(
+          "Batch of %d rows needs %d bytes, more than the slot size %d", rows, size, capacity));
+    }
+
+    std::memcpy(dst, &header, sizeof(header));
+    std::memcpy(dst + sizeof(header), columns.data(), columns.size() * sizeof(ColumnDesc));
+    Copy(dst + header.group_ids, batch.group_ids());
+    Copy(dst + header.labels, batch.labels());
+    Copy(dst + header.labels, batch.labels_uint8());
+    Copy(dst + header.timestamps, batch.timestamps());
+    Copy(dst + header.group_offsets, batch.group_offsets());
+    Copy(dst + header.unique_ids, batch.unique_ids());
+    auto* id_offsets = reinterpret_cast<uint32_t*>(dst + header.sample_id_offsets);
+    char* chars = dst + header.sample_id_chars;
+    id_offsets[0] = 0;
+    for (size_t i = 0; i < rows; ++i) {
+      const auto& id = batch.sample_ids()[i];
+      std::memcpy(chars + id_offsets[i], id.data(), id.size());
+      id_offsets[i + 1] = id_offsets[i] + id.size();
+    }
+    size_t c = 0;
+    for (const auto& column : batch.sparse_columns()) {
+      // 只有与 dtype 对应的一个数组非空
+      Copy(dst + columns[c].values, column.ids);
+      Copy(dst + columns[c].values, column.ids32);
+      Copy(dst + columns[c].weights, column.weights);
+      Copy(dst + columns[c].offsets, column.offsets);
+      Copy(dst + columns[c].unique_ids, column.unique_ids);
+      Copy(dst + columns[c].inverse, column.inverse);
+      ++c;
+    }
+    for (const auto& column : batch.dense_columns()) {
+      Copy(dst + columns[c].values, column.values);
+      Copy(dst + columns[c].values, column.half_values);
+      ++c;
+    }
+    return size;
+  }
+
+  ShmSampleBatch(std::shared_ptr<ShmRing> ring, uint32_t slot)
+      : ring_(std::move(ring)), slot_(slot), data_(ring_->slot_data(slot)) {
+    std::memcpy(&header_, data_, sizeof(header_));
+  }
+
+  ~ShmSampleBatch() final { ring_->release(slot_); }
+
+  std::shared_ptr<DataObjectMeta> data_meta() const final {
+    static std::shared_ptr<DataObjectMeta> meta = std::make_shared<ShmSampleBatchMeta>();
+    return meta;
+  }
+
+  void* ptr() final { return this; }
+
+  size_t rows() const { return header_.rows; }
+
+  std::span<const uint64_t> group_ids() const { return array<uint64_t>(header_.group_ids, rows()); }
+  /**
+   * @brief Labels, stored in labels() or, with label_dtype kUint8, in labels_uint8().
+   */
+  LabelDType label_dtype() const { return static_cast<LabelDType>(header_.label_dtype); }
+  std::span<const float> labels() const {
+    return array<float>(header_.labels, label_dtype() == LabelDType::kFloat32 ? rows() : 0);
+  }
+  std::span<const uint8_t> labels_uint8() const {
+    return array<uint8_t>(header_.labels, label_dtype() == LabelDType::kUint8 ? rows() : 0);
+  }
+  std::span<const int64_t> timestamps() const { return array<int64_t>(header_.timestamps, rows()); }
+  std::span<const uint32_t> group_offsets() const {
+    return array<uint32_t>(header_.group_offsets, header_.num_group_offsets);
+  }
+
+  /**
+   * @brief Unique ids of a global SparseDedup, see SampleBatch::unique_ids().
+   */
+  std::span<const uint64_t> unique_ids() const {
+    return array<uint64_t>(header_.unique_ids, header_.num_unique_ids);
+  }
+
+  std::string_view sample_id(size_t row) const {
+    auto offsets = array<uint32_t>(header_.sample_id_offsets, rows() + 1);
+    return std::string_view(data_ + header_.sample_id_chars + offsets[row],
+                            offsets[row + 1] - offsets[row]);
+  }
+
+  std::vector<int64_t> sparse_slots() const {
+    std::vector<int64_t> slots;
+    for (uint32_t i = 0; i < header_.num_sparse; ++i) {
+      slots.push_back(column_desc(i).slot);
+    }
+    return slots;
+  }
+
+  std::vector<int64_t> dense_slots() const {
+    std::vector<int64_t> slots;
+    for (uint32_t i = 0; i < header_.num_dense; ++i) {
+      slots.push_back(column_desc(header_.num_sparse + i).slot);
+    }
+    return slots;
+  }
+
+  /**
+   * @brief Find the sparse column of the given slot.
+   * @return The column, or std::nullopt if the slot is not present in this batch.
+   */
+  std::optional<ShmSparseColumn> find_sparse(int64_t slot) const {
+    for (uint32_t i = 0; i < header_.num_sparse; ++i) {
+      const ColumnDesc desc = column_desc(i);
+      if (desc.slot == slot) {
+        ShmSparseColumn column;
+        column.slot = slot;
+        column.id_dtype = static_cast<SparseIdDType>(desc.dtype);
+        if (column.id_dtype == SparseIdDType::kUint32) {
+          column.ids32 = array<uint32_t>(desc.values, desc.size);
+        } else {
+          column.ids = array<uint64_t>(desc.values, desc.size);
+        }
+        column.weights = array<float>(desc.weights, desc.size);
+        column.offsets = array<uint32_t>(desc.offsets, rows() + 1);
+        column.unique_ids = array<uint64_t>(desc.unique_ids, desc.num_unique_ids);
+        column.inverse = array<uint32_t>(desc.inverse, desc.num_inverse);
+        return column;
+      }
+    }
+    return std::nullopt;
+  }
+
+  /**
+   * @brief Find the dense column of the given slot.
+   * @return The column, or std::nullopt if the slot is not present in this batch.
+   */
+  std::optional<ShmDenseColumn> find_dense(int64_t slot) const {
+    for (uint32_t i = 0; i < header_.num_dense; ++i) {
+      const ColumnDesc desc = column_desc(header_.num_sparse + i);
+      if (desc.slot == slot) {
+        ShmDenseColumn column;
+        column.slot = slot;
+        column.width = static_cast<uint32_t>(desc.size);
+        column.dtype = static_cast<DenseDType>(desc.dtype);
+        if (column.dtype == DenseDType::kFloat32) {
+          column.values = array<float>(desc.values, rows() * column.width);
+        } else {
+          column.half_values = array<uint16_t>(desc.values, rows() * column.width);
+        }
+        return column;
+      }
+    }
+    return std::nullopt;
+  }
+
+ private:
+  static constexpr size_t kAlignment = 64;
+
+  struct Header {
+    uint64_t rows;
+    uint32_t num_sparse;
+    uint32_t num_dense;
+    // LabelDType
+    uint32_t label_dtype;
+    uint64_t num_group_offsets;
+    uint64_t group_ids;
+    uint64_t labels;
+    uint64_t timestamps;
+    uint64_t group_offsets;
+    uint64_t sample_id_offsets;
+    uint64_t sample_id_chars;
+    uint64_t num_unique_ids;
+    uint64_t unique_ids;
+  };
+
+  // sparse: size 为 id 个数，dtype 为 SparseIdDType；
+  // dense: size 为宽度，dtype 为 DenseDType，只使用 values
+  struct ColumnDesc {
+    int64_t slot;
+    uint32_t dtype;
+    uint64_t size;
+    uint64_t values;
+    uint64_t weights;
+    uint64_t offsets;
+    uint64_t num_unique_ids;
+    uint64_t unique_ids;
+    uint64_t num_inverse;
+    uint64_t inverse;
+  };
+
+  static size_t Align(size_t size) { return (size + kAlignment - 1) / kAlignment * kAlignment; }
+
+  template <typename T>
+  static void Copy(char* dst, const std::vector<T>& values) {
+    if (!values.empty()) {
+      std::memcpy(dst, values.data(), values.size() * sizeof(T));
+    }
+  }
+
+  template <typename T>
+  std::span<const T> array(uint64_t offset, size_t size) const {
+    return std::span<const T>(reinterpret_cast<const T*>(data_ + offset), size);
+  }
+
+  ColumnDesc column_desc(uint32_t index) const {
+    ColumnDesc desc;
+    std::memcpy(&desc, data_ + sizeof(Header) + index * sizeof(ColumnDesc), sizeof(desc));
+    return desc;
+  }
+
+  std::shared_ptr<ShmRing> ring_;
+  uint32_t slot_;
+  const char* data_;
+  Header header_;
+};
+
+}  // namespace data_flow
@@ -10,7 +10,10 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
+#include <list>
+#include <memory>
 #include <stdexcept>
 
 #include "glog/logging.h"
@@ -20,20 +23,51 @@
 #include "DataFlow/csrc/core/data_object.h"
 #include "DataFlow/csrc/core/data_pipeline.h"
 #include "DataFlow/csrc/data_objects/byte_stream.h"
+#include "DataFlow/csrc/io/file_discovery.h"
+#include "DataFlow/csrc/io/file_system_registry.h"
+#include "DataFlow/csrc/io/readahead_reader.h"
+#include "DataFlow/csrc/io/stream_file.h"
 
 namespace data_flow {
 
 static constexpr size_t kDefaultBufferSize = 4096;
+// 与 pipe 默认容量一致，一次读取即可取空 pipe
+static constexpr size_t kStreamBufferSize = 64 * 1024;
+// 远程文件由 ReadaheadReader 按 chunk 预读，ByteStream 以较大的块从中拷出
+static constexpr size_t kRemoteBufferSize = 1 << 20;
 
+/**
+ * @brief DataReader produces one ByteStream per input.
+ *
+ * - kFileList: inputs are files; FIFOs, Unix domain sockets ("unix://"), "fifo://" uris and "-"
+ *   (stdin) in the list are read as streams. Uris with a scheme registered in FileSystemRegistry
+ *   ("http://", "webhdfs://", "hdfs://") are read with concurrent range requests, see
+ *   ReadaheadReader; all of them share one ReadaheadPool of readahead_options.num_threads threads.
+ * - kStream: inputs are never-ending streams read with stream_options, see StreamFile. Streams are
+ *   consumed in order, the next one is opened when the previous one ends.
+ * - kPattern: inputs are glob patterns or directories expanded lazily by FileDiscovery; files are
+ *   read while the directory walk is still running.
+ */
 class DataReader final : public DataPipeline {
  public:
-  enum class FileSource : int8_t { kFileList, kStringStream };
+  enum class FileSource : int8_t { kFileList, kStringStream, kStream, kPattern };
 
  public:
-  DataReader(const std::vector<std::string>&& files)
-      : file_source_(FileSource::kFileList), file_paths_(files.begin(), files.end()) {
-    file_type_ = !files.empty() && Func::starts_with(files[0], "hdfs://") ? FileType::kHDFSFile
-                                                                          : FileType::kLocalFile;
+  DataReader(const std::vector<std::string>&& files,
+             FileSource file_source = FileSource::kFileList,
+             const StreamFileOptions& stream_options = {},
+             const FileDiscoveryOptions& discovery_options = {},
+             const ReadaheadOptions& readahead_options = {})
+      : file_source_(file_source),
+        file_paths_(files.begin(), files.end()),
+        stream_options_(stream_options),
+        discovery_options_(discovery_options),
+        readahead_options_(readahead_options),
+        readahead_pool_(std::make_shared<ReadaheadPool>(readahead_options.num_threads)) {
+    if (file_source_ == FileSource::kPattern) {
+      // 构造时即开始遍历目录，与后续读取重叠
+      discovery_ = std::make_unique<FileDiscovery>(files, discovery_options_.num_threads);
+    }
   }
 
   // TODO: DataReader(std::shared_ptr<DataObject> string_stream);
@@ -48,7 +82,11 @@ class DataReader final : public DataPipeline {
   absl::StatusOr<std::shared_ptr<DataObject>> next() final {
     switch (file_source_) {
       case FileSource::kFileList:
-        return stream_from_file_list(file_paths_.front());
+        return stream_from_file_list();
+      case FileSource::kStream:
+        return stream_from_stream_list();
+      case FileSource::kPattern:
+        return stream_from_discovery();
       // case FileSource::kStringStream:
       //     return stream_from_string_stream(string_stream_);
       default:
@@ -70,27 +108,82 @@ class DataReader final : public DataPipeline {
   }
 
  private:
-  absl::StatusOr<std::shared_ptr<DataObject>> stream_from_file_list(const std::string& file_path) {
+  absl::StatusOr<std::shared_ptr<DataObject>> stream_from_file_list() {
     if (file_paths_.empty()) {
       VLOG(3) << "[DataReader] end of input";
       return nullptr;  // End of iteration
     }
 
-    switch (file_type_) {
-      case FileType::kLocalFile: {
-        std::string current_file = file_paths_.front();
-        file_paths_.pop_front();
+    std::string current_file = file_paths_.front();
+    file_paths_.pop_front();
+
+    if (StreamFile::IsStreamUri(current_file)) {
+      return open_stream(current_file, StreamFileOptions{});
+    }
+    if (FileSystemRegistry::Instance().is_remote(current_file)) {
+      return open_remote(current_file);
+    }
 
-        // TODO: CHECK_F(Func::starts_with(current_file, "hdfs://"));
+    auto stream = std::make_shared<ByteStream>(std::move(current_file), kDefaultBufferSize);
+    return stream;
+  }
 
-        auto stream = std::make_shared<ByteStream>(std::move(current_file), kDefaultBufferSize);
-        return stream;
-      } break;
-      case FileType::kHDFSFile:
-        return absl::UnimplementedError("HDFS file support not implemented yet");
-      default:
-        return absl::InvalidArgumentError("Unknown file type");
+  absl::StatusOr<std::shared_ptr<DataObject>> stream_from_stream_list() {
+    if (file_paths_.empty()) {
+      VLOG(3) << "[DataReader] end of input streams";
+      return nullptr;
     }
+    std::string uri = file_paths_.front();
+    file_paths_.pop_front();
+    return open_stream(uri, stream_options_);
+  }
+
+  absl::StatusOr<std::shared_ptr<DataObject>> stream_from_discovery() {
+    // 维护 lookahead 个已发现文件组成的大顶堆，优先读取大文件
+    auto by_size = [](const FileEntry& a, const FileEntry& b) { return a.size < b.size; };
+    while (lookahead_.size() < std::max<size_t>(discovery_options_.lookahead, 1)) {
+      auto status_or_entry = discovery_->next();
+      if (!status_or_entry.ok()) {
+        return status_or_entry.status();
+      }
+      if (!status_or_entry->has_value()) {
+        break;
+      }
+      if (discovery_options_.skip_empty && status_or_entry->value().size == 0) {
+        continue;
+      }
+      lookahead_.push_back(std::move(status_or_entry->value()));
+      std::push_heap(lookahead_.begin(), lookahead_.end(), by_size);
+    }
+
+    if (lookahead_.empty()) {
+      VLOG(3) << "[DataReader] end of discovered files: " << discovery_->discovered_files()
+              << " files, " << discovery_->discovered_bytes() << " bytes";
+      return nullptr;
+    }
+    std::pop_heap(lookahead_.begin(), lookahead_.end(), by_size);
+    FileEntry entry = std::move(lookahead_.back());
+    lookahead_.pop_back();
+    return std::make_shared<ByteStream>(std::move(entry.path), kDefaultBufferSize);
+  }
+
+  static absl::StatusOr<std::shared_ptr<DataObject>> open_stream(
+      const std::string& uri, const StreamFileOptions& options) {
+    auto status_or_file = StreamFile::Open(uri, options);
+    if (!status_or_file.ok()) {
+      return status_or_file.status();
+    }
+    return std::make_shared<ByteStream>(std::move(status_or_file).value(), kStreamBufferSize);
+  }
+
+  absl::StatusOr<std::shared_ptr<DataObject>> open_remote(const std::string& uri) const {
+    auto status_or_file = FileSystemRegistry::Instance().open(uri);
+    if (!status_or_file.ok()) {
+      return status_or_file.status();
+    }
+    auto reader = std::make_unique<ReadaheadReader>(std::move(status_or_file).value(),
+                                                    readahead_options_, readahead_pool_);
+    return std::make_shared<ByteStream>(std::move(reader), kRemoteBufferSize);
   }
 
   /** TODO:
@@ -107,12 +200,16 @@ class DataReader final : public DataPipeline {
         auto stream = std::make_shared<Stream>(std::move(f), kDefaultBufferSize);
         return stream;
     }*/
-  enum class FileType : int8_t { kLocalFile, kHDFSFile };
-
   FileSource file_source_;
 
   std::list<std::string> file_paths_;
-  FileType file_type_;
+  StreamFileOptions stream_options_;
+  FileDiscoveryOptions discovery_options_;
+  ReadaheadOptions readahead_options_;
+  // 远程文件的 fetch 共享这些线程，同时打开多个远程流时线程数不随流数增长
+  std::shared_ptr<ReadaheadPool> readahead_pool_;
+  std::unique_ptr<FileDiscovery> discovery_;
+  std::vector<FileEntry> lookahead_;
 
   // TODO: std::shared_ptr<StringStream> string_stream_;
 };
@@ -0,0 +1,86 @@
+/**
+ * @file feature_generator.h
+ * @brief Definition of FeatureGenerator pipeline running compiled FG transforms over batches.
+ *
+ * Author: Jasmine (1011694931@qq.com)
+ * Created on: 2025-11-8
+ *
+ * Copyright (c) 2025 Jasmine. All rights reserved.
+ */
+
+#pragma once
+
+#include <stdexcept>
+
+#include "glog/logging.h"
+#include "pybind11/pybind11.h"
+
+#include "DataFlow/csrc/core/data_object.h"
+#include "DataFlow/csrc/core/data_pipeline.h"
+#include "DataFlow/csrc/data_objects/sample_batch.h"
+#include "DataFlow/csrc/fg/fg_graph.h"
+
+namespace data_flow {
+
+/**
+ * @brief FeatureGenerator applies a FG spec to every SampleBatch of its input pipeline. The spec
+ * is compiled once in the constructor; each batch then runs through the compiled kernels and a
+ * new batch holding the generated columns is produced.
+ */
+class FeatureGenerator final : public DataPipeline {
+ public:
+  FeatureGenerator(const std::shared_ptr<DataPipeline>& data_pipeline,
+                   const std::vector<FgOpSpec>& specs, bool keep_inputs = true)
+      : keep_inputs_(keep_inputs) {
+    CHECK(data_pipeline->output_data_meta()->data_type() == typeid(SampleBatch))
+        << "Input DataPipeline must produce SampleBatch, got: "
+        << data_pipeline->output_data_meta()->data_type().name();
+    input_ = data_pipeline;
+
+    auto status_or_graph = FgGraph::Compile(specs);
+    if (!status_or_graph.ok()) {
+      throw std::invalid_argument(std::string(status_or_graph.status().message()));
+    }
+    graph_ = std::move(status_or_graph).value();
+    VLOG(3) << "[FeatureGenerator] compiled " << graph_.ops().size() << " FG ops";
+  }
+
+  std::shared_ptr<DataObjectMeta> output_data_meta() const final {
+    static std::shared_ptr<DataObjectMeta> meta = std::make_shared<SampleBatchMeta>();
+    return meta;
+  }
+
+  absl::StatusOr<std::shared_ptr<DataObject>> next() final {
+    auto status_or_obj = input_->next();
+    if (!status_or_obj.ok()) {
+      return status_or_obj.status();
+    }
+
+    auto obj = status_or_obj.value();
+    if (obj == nullptr) {
+      VLOG(3) << "[FeatureGenerator] end of input pipeline";
+      return nullptr;
+    }
+
+    auto status_or_batch = graph_.run(obj->as<SampleBatch>(), keep_inputs_);
+    if (!status_or_batch.ok()) {
+      return status_or_batch.status();
+    }
+    return std::shared_ptr<DataObject>(std::move(status_or_batch).value());
+  }
+
+  PyObject* as_python_object(std::shared_ptr<DataObject> data_object) const final {
+    CHECK(data_object->data_meta()->data_type() == typeid(SampleBatch))
+        << "DataObject is not of type SampleBatch, got: "
+        << data_object->data_meta()->data_type().name();
+
+    auto batch_ptr = std::dynamic_pointer_cast<SampleBatch>(data_object->shared_from_this());
+    return pybind11::cast(batch_ptr).release().ptr();
+  }
+
+ private:
+  std::shared_ptr<DataPipeline> input_;
+  FgGraph graph_;
+  bool keep_inputs_;
+};
+}  // namespace data_flow
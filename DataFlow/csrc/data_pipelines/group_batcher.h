@@ -0,0 +1,366 @@
+/**
+ * @file group_batcher.h
+ * @brief Definition of GroupBatcher pipeline packing samples of the same group into one batch.
+ *
+ * Author: Jasmine (1011694931@qq.com)
+ * Created on: 2025-11-10
+ *
+ * Copyright (c) 2025 Jasmine. All rights reserved.
+ */
+
+#pragma once
+
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <vector>
+
+#include "glog/logging.h"
+#include "pybind11/pybind11.h"
+
+#include "DataFlow/csrc/common/functions.h"
+#include "DataFlow/csrc/core/data_object.h"
+#include "DataFlow/csrc/core/data_pipeline.h"
+#include "DataFlow/csrc/data_objects/sample_batch.h"
+
+namespace data_flow {
+
+/**
+ * @brief Flush policy of GroupBatcher.
+ *
+ * A group is complete, and becomes ready to be emitted, when
+ * - no row of the group arrived during the last window_batches input batches, or
+ * - the group has been open for more than timeout_ms milliseconds (0 disables the timeout), or
+ * - max_groups groups are open and a new group arrives: the least recently extended group is
+ *   flushed to make room, or
+ * - the input pipeline is exhausted.
+ *
+ * Groups flushed by the timeout are emitted without waiting for max_rows rows. The timeout is
+ * checked whenever next() is called and after every input batch, so it bounds the latency as long
+ * as the input pipeline keeps returning, but not while it blocks.
+ */
+struct GroupBatcherOptions {
+  size_t max_rows = 1024;
+  size_t max_groups = 65536;
+  size_t window_batches = 1;
+  int64_t timeout_ms = 0;
+};
+
+/**
+ * @brief GroupBatcher regroups the SampleBatch of its input pipeline by group id. Rows of the same
+ * group always end up contiguous in the same output batch; complete groups are packed into output
+ * batches of at most max_rows rows, and SampleBatch::group_offsets() holds the row offsets of the
+ * groups. A group larger than max_rows is emitted alone in its own batch.
+ *
+ * Open groups are kept in a bounded open-addressing hash table. Rows are not copied until their
+ * group is emitted: groups reference rows of the input batches, which are kept alive until all
+ * their rows are emitted.
+ */
+class GroupBatcher final : public DataPipeline {
+ public:
+  GroupBatcher(const std::shared_ptr<DataPipeline>& data_pipeline,
+               const GroupBatcherOptions& options = {})
+      : options_(options) {
+    CHECK(data_pipeline->output_data_meta()->data_type() == typeid(SampleBatch))
+        << "Input DataPipeline must produce SampleBatch, got: "
+        << data_pipeline->output_data_meta()->data_type().name();
+    CHECK_GT(options_.max_rows, 0) << "max_rows must be positive";
+    CHECK_GT(options_.max_groups, 0) << "max_groups must be positive";
+    CHECK_LT(options_.max_groups, kNil) << "max_groups is too large";
+    input_ = data_pipeline;
+
+    // 负载因子不超过 0.5，保证线性探测的探测长度较短
+    table_.assign(std::bit_ceil(options_.max_groups * 2), kNil);
+    groups_.reserve(options_.max_groups);
+  }
+
+  std::shared_ptr<DataObjectMeta> output_data_meta() const final {
+    static std::shared_ptr<DataObjectMeta> meta = std::make_shared<SampleBatchMeta>();
+    return meta;
+  }
+
+  absl::StatusOr<std::shared_ptr<DataObject>> next() final {
+    while (true) {
+      if (ready_rows_ >= options_.max_rows || ((input_done_ || timed_out_) && !ready_.empty())) {
+        return pack();
+      }
+      timed_out_ = false;
+      if (input_done_) {
+        if (open_groups_ == 0) {
+          VLOG(3) << "[GroupBatcher] end of input pipeline";
+          return nullptr;
+        }
+        while (lru_.head != kNil) {
+          flush(lru_.head);
+        }
+        continue;
+      }
+      // 阻塞读取上游之前先按超时 flush，超时的组不必等下一个输入 batch
+      if (expire()) {
+        continue;
+      }
+
+      auto status_or_obj = input_->next();
+      if (!status_or_obj.ok()) {
+        return status_or_obj.status();
+      }
+      auto obj = status_or_obj.value();
+      if (obj == nullptr) {
+        input_done_ = true;
+        continue;
+      }
+      add(std::static_pointer_cast<SampleBatch>(obj));
+      expire();
+    }
+  }
+
+  PyObject* as_python_object(std::shared_ptr<DataObject> data_object) const final {
+    CHECK(data_object->data_meta()->data_type() == typeid(SampleBatch))
+        << "DataObject is not of type SampleBatch, got: "
+        << data_object->data_meta()->data_type().name();
+
+    auto batch_ptr = std::dynamic_pointer_cast<SampleBatch>(data_object->shared_from_this());
+    return pybind11::cast(batch_ptr).release().ptr();
+  }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+  static constexpr uint32_t kNil = std::numeric_limits<uint32_t>::max();
+
+  /**
+   * @brief Reference to a row of a buffered input batch.
+   */
+  struct RowRef {
+    uint64_t batch_seq;
+    uint32_t row;
+  };
+
+  /**
+   * @brief Input batch kept alive until all its rows are emitted.
+   */
+  struct PendingBatch {
+    std::shared_ptr<const SampleBatch> batch;
+    size_t pending_rows;
+  };
+
+  /**
+   * @brief Intrusive doubly linked list over groups_, linked through the `links` member at index
+   * kLink of the group.
+   */
+  template <int kLink>
+  struct GroupList {
+    uint32_t head = kNil;
+    uint32_t tail = kNil;
+  };
+
+  struct OpenGroup {
+    uint64_t group_id = 0;
+    std::vector<RowRef> rows;
+    uint64_t last_batch_seq = 0;
+    Clock::time_point opened;
+    // [0]: 按最近追加时间排序的链表，[1]: 按创建时间排序的链表，{prev, next}
+    uint32_t links[2][2] = {{kNil, kNil}, {kNil, kNil}};
+  };
+
+  template <int kLink>
+  void list_push_back(GroupList<kLink>* list, uint32_t index) {
+    auto& link = groups_[index].links[kLink];
+    link[0] = list->tail;
+    link[1] = kNil;
+    if (list->tail != kNil) {
+      groups_[list->tail].links[kLink][1] = index;
+    } else {
+      list->head = index;
+    }
+    list->tail = index;
+  }
+
+  template <int kLink>
+  void list_erase(GroupList<kLink>* list, uint32_t index) {
+    auto& link = groups_[index].links[kLink];
+    if (link[0] != kNil) {
+      groups_[link[0]].links[kLink][1] = link[1];
+    } else {
+      list->head = link[1];
+    }
+    if (link[1] != kNil) {
+      groups_[link[1]].links[kLink][0] = link[0];
+    } else {
+      list->tail = link[0];
+    }
+  }
+
+  size_t bucket_of(uint64_t group_id) const {
+    return Func::mix64(group_id) & (table_.size() - 1);
+  }
+
+  /**
+   * @brief Find the table bucket holding group_id, or the empty bucket where it would be inserted.
+   */
+  size_t probe(uint64_t group_id) const {
+    const size_t mask = table_.size() - 1;
+    size_t bucket = bucket_of(group_id);
+    while (table_[bucket] != kNil && groups_[table_[bucket]].group_id != group_id) {
+      bucket = (bucket + 1) & mask;
+    }
+    return bucket;
+  }
+
+  /**
+   * @brief Remove the group at `bucket` from the table with backward shift deletion, so the table
+   * never accumulates tombstones.
+   */
+  void table_erase(size_t bucket) {
+    const size_t mask = table_.size() - 1;
+    size_t hole = bucket;
+    size_t next = (hole + 1) & mask;
+    while (table_[next] != kNil) {
+      size_t home = bucket_of(groups_[table_[next]].group_id);
+      // next 的探测路径经过 hole 时才能前移
+      if (((next - home) & mask) >= ((next - hole) & mask)) {
+        table_[hole] = table_[next];
+        hole = next;
+      }
+      next = (next + 1) & mask;
+    }
+    table_[hole] = kNil;
+  }
+
+  void add(std::shared_ptr<const SampleBatch> batch) {
+    const uint64_t seq = batch_seq_++;
+    const auto& group_ids = batch->group_ids();
+    pending_.push_back(PendingBatch{batch, group_ids.size()});
+
+    const auto now = Clock::now();
+    for (uint32_t row = 0; row < group_ids.size(); ++row) {
+      size_t bucket = probe(group_ids[row]);
+      uint32_t index = table_[bucket];
+      if (index == kNil) {
+        if (open_groups_ == options_.max_groups) {
+          flush(lru_.head);
+          bucket = probe(group_ids[row]);
+        }
+        index = allocate();
+        auto& group = groups_[index];
+        group.group_id = group_ids[row];
+        group.opened = now;
+        table_[bucket] = index;
+        list_push_back(&age_, index);
+        ++open_groups_;
+      } else {
+        list_erase(&lru_, index);
+      }
+      auto& group = groups_[index];
+      group.rows.push_back(RowRef{seq, row});
+      group.last_batch_seq = seq;
+      list_push_back(&lru_, index);
+    }
+  }
+
+  /**
+   * @brief Flush the groups that are complete according to the window and timeout policy.
+   * @return true if a group was flushed by the timeout; the ready groups are then emitted as a
+   * partial batch.
+   */
+  bool expire() {
+    while (lru_.head != kNil &&
+           batch_seq_ - groups_[lru_.head].last_batch_seq > options_.window_batches) {
+      flush(lru_.head);
+    }
+    if (options_.timeout_ms > 0) {
+      const auto deadline = Clock::now() - std::chrono::milliseconds(options_.timeout_ms);
+      while (age_.head != kNil && groups_[age_.head].opened <= deadline) {
+        flush(age_.head);
+        timed_out_ = true;
+      }
+    }
+    return timed_out_;
+  }
+
+  /**
+   * @brief Move an open group to the ready queue.
+   */
+  void flush(uint32_t index) {
+    auto& group = groups_[index];
+    table_erase(probe(group.group_id));
+    list_erase(&lru_, index);
+    list_erase(&age_, index);
+    --open_groups_;
+
+    ready_rows_ += group.rows.size();
+    ready_.push_back(std::move(group.rows));
+    group.rows = {};
+    free_.push_back(index);
+  }
+
+  uint32_t allocate() {
+    if (!free_.empty()) {
+      uint32_t index = free_.back();
+      free_.pop_back();
+      return index;
+    }
+    groups_.emplace_back();
+    return groups_.size() - 1;
+  }
+
+  /**
+   * @brief Pack ready groups into an output batch of at most max_rows rows.
+   */
+  absl::StatusOr<std::shared_ptr<DataObject>> pack() {
+    auto batch = std::make_shared<SampleBatch>();
+    SampleBatchAppender appender(batch.get());
+    auto& group_offsets = batch->group_offsets();
+    group_offsets.push_back(0);
+
+    while (!ready_.empty()) {
+      auto& rows = ready_.front();
+      if (group_offsets.back() != 0 && group_offsets.back() + rows.size() > options_.max_rows) {
+        break;
+      }
+      for (const auto& ref : rows) {
+        auto& pending = pending_[ref.batch_seq - pending_base_seq_];
+        auto status = appender.append(pending.batch, ref.row);
+        if (!status.ok()) {
+          return status;
+        }
+        --pending.pending_rows;
+      }
+      ready_rows_ -= rows.size();
+      group_offsets.push_back(batch->rows());
+      ready_.pop_front();
+    }
+
+    // 释放所有行都已输出的输入 batch
+    while (!pending_.empty() && pending_.front().pending_rows == 0) {
+      pending_.pop_front();
+      ++pending_base_seq_;
+    }
+    return std::shared_ptr<DataObject>(batch);
+  }
+
+  std::shared_ptr<DataPipeline> input_;
+  GroupBatcherOptions options_;
+  bool input_done_ = false;
+  // 有组因超时 flush，ready 的组不足 max_rows 也立即输出
+  bool timed_out_ = false;
+
+  // open groups
+  std::vector<uint32_t> table_;
+  std::vector<OpenGroup> groups_;
+  std::vector<uint32_t> free_;
+  size_t open_groups_ = 0;
+  GroupList<0> lru_;
+  GroupList<1> age_;
+
+  // buffered input batches, pending_[i] has sequence number pending_base_seq_ + i
+  std::deque<PendingBatch> pending_;
+  uint64_t pending_base_seq_ = 0;
+  uint64_t batch_seq_ = 0;
+
+  // complete groups waiting to be emitted
+  std::deque<std::vector<RowRef>> ready_;
+  size_t ready_rows_ = 0;
+};
+}  // namespace data_flow
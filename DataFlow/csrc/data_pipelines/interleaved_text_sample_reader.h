@@ -0,0 +1,300 @@
+/**
+ * @file interleaved_text_sample_reader.h
+ * @brief Definition of InterleavedTextSampleReader, a TextSampleParser reading many streams at
+ * once on a coroutine scheduler.
+ *
+ * Author: Jasmine (1011694931@qq.com)
+ * Created on: 2025-11-18
+ *
+ * Copyright (c) 2025 Jasmine. All rights reserved.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <span>
+#include <string>
+
+#include "glog/logging.h"
+#include "pybind11/pybind11.h"
+
+#include "DataFlow/csrc/core/async_data_pipeline.h"
+#include "DataFlow/csrc/core/data_object.h"
+#include "DataFlow/csrc/coro/channel.h"
+#include "DataFlow/csrc/coro/scheduler.h"
+#include "DataFlow/csrc/data_objects/byte_stream.h"
+#include "DataFlow/csrc/data_objects/inflate_stream.h"
+#include "DataFlow/csrc/data_objects/sample_batch.h"
+#include "DataFlow/csrc/parsers/text_line_parser.h"
+
+namespace data_flow {
+
+struct InterleavedReaderOptions {
+  // 运行协程的 worker 线程数
+  size_t num_threads = 4;
+  // 同时读取的流数，每个流由一个协程解析
+  size_t max_open_streams = 64;
+  // 已解析、等待 next() 取走的 batch 数
+  size_t queue_capacity = 16;
+};
+
+/**
+ * @brief InterleavedTextSampleReader parses the streams of its input pipeline (ByteStream or
+ * InflateStream) into SampleBatch like TextSampleParser, but reads up to max_open_streams streams
+ * at once on num_threads worker threads. Each stream is parsed by its own coroutine, which is
+ * suspended while its stream has no data, so slow FIFOs, sockets and remote files hold no worker
+ * thread. The range reads of remote files run on the ReadaheadPool of the DataReader, shared by
+ * all of them, so readahead_threads bounds the fetch threads however many streams are open.
+ *
+ * Batches hold rows of one stream and at most batch_size rows; the last batch of each stream may
+ * be smaller. Batches come out in the order they are completed, not in the order of the input.
+ * Destruction cancels the coroutines waiting for data, so it does not hang on idle streams, and
+ * waits for the other reads in flight.
+ */
+class InterleavedTextSampleReader final : public AsyncDataPipeline {
+ public:
+  InterleavedTextSampleReader(const std::shared_ptr<DataPipeline>& data_pipeline,
+                              size_t batch_size, const TextSampleOptions& text_options = {},
+                              const InterleavedReaderOptions& options = {})
+      : scheduler_(options.num_threads),
+        input_(data_pipeline),
+        batch_size_(batch_size),
+        text_options_(text_options),
+        num_lanes_(std::max<size_t>(options.max_open_streams, 1)),
+        streams_(&scheduler_, 1),
+        batches_(&scheduler_, options.queue_capacity) {
+    auto input_type = data_pipeline->output_data_meta()->data_type();
+    CHECK(input_type == typeid(ByteStream) || input_type == typeid(InflateStream))
+        << "Input DataPipeline must produce ByteStream or InflateStream, got: "
+        << input_type.name();
+    CHECK_GT(batch_size_, 0) << "batch_size must be positive";
+  }
+
+  ~InterleavedTextSampleReader() final {
+    stop();
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [&] { return running_ == 0; });
+    VLOG(1) << "[InterleavedTextSampleReader] destructor";
+  }
+
+  std::shared_ptr<DataObjectMeta> output_data_meta() const final {
+    static std::shared_ptr<DataObjectMeta> meta = std::make_shared<SampleBatchMeta>();
+    return meta;
+  }
+
+  Task<absl::StatusOr<std::shared_ptr<DataObject>>> next_async() final {
+    std::call_once(started_, [this] { start(); });
+    auto batch = co_await batches_.pop();
+    if (batch.has_value()) {
+      co_return std::shared_ptr<DataObject>(std::move(batch).value());
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!error_.ok()) {
+      co_return error_;
+    }
+    VLOG(3) << "[InterleavedTextSampleReader] end of input pipeline, rows filtered: "
+            << rows_filtered_.load();
+    co_return nullptr;
+  }
+
+  Scheduler& scheduler() final { return scheduler_; }
+
+  PyObject* as_python_object(std::shared_ptr<DataObject> data_object) const final {
+    CHECK(data_object->data_meta()->data_type() == typeid(SampleBatch))
+        << "DataObject is not of type SampleBatch, got: "
+        << data_object->data_meta()->data_type().name();
+
+    auto batch_ptr = std::dynamic_pointer_cast<SampleBatch>(data_object->shared_from_this());
+    return pybind11::cast(batch_ptr).release().ptr();
+  }
+
+  /**
+   * @brief Number of rows rejected by the row predicate in the streams finished so far.
+   */
+  uint64_t rows_filtered() const { return rows_filtered_.load(); }
+
+ private:
+  static constexpr size_t kInflateChunkSize = 1 << 20;  // 1 MB
+
+  void start() {
+    running_ = num_lanes_ + 1;
+    lanes_running_ = num_lanes_;
+    scheduler_.spawn(Supervise(this, open_streams()));
+    for (size_t i = 0; i < num_lanes_; ++i) {
+      scheduler_.spawn(Supervise(this, lane()));
+    }
+  }
+
+  void stop() {
+    stopping_ = true;
+    streams_.close();
+    batches_.close();
+    // 等待空闲 FIFO、socket 的协程可能永远不会被唤醒，取消其等待
+    scheduler_.cancel_waits();
+  }
+
+  void set_error(absl::Status status) {
+    if (stopping_) {
+      // 停止后其余协程因等待被取消而失败，不再记录
+      return;
+    }
+    LOG(ERROR) << "[InterleavedTextSampleReader] " << status;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (error_.ok()) {
+        error_ = std::move(status);
+      }
+    }
+    stop();
+  }
+
+  /**
+   * @brief Run a coroutine of the reader and count it out once its frame is gone, so that the
+   * destructor does not release members it still uses.
+   */
+  static Task<void> Supervise(InterleavedTextSampleReader* self, Task<void> task) {
+    co_await std::move(task);
+    std::lock_guard<std::mutex> lock(self->mutex_);
+    if (--self->running_ == 0) {
+      self->done_cv_.notify_all();
+    }
+  }
+
+  /**
+   * @brief Pull the streams of the input pipeline into streams_.
+   */
+  Task<void> open_streams() {
+    while (!stopping_) {
+      absl::StatusOr<std::shared_ptr<DataObject>> status_or_obj;
+      try {
+        status_or_obj = co_await NextAsync(input_.get());
+      } catch (const std::exception& e) {
+        // 例如 ByteStream 打开本地文件失败
+        status_or_obj = absl::UnavailableError(e.what());
+      }
+      if (!status_or_obj.ok()) {
+        set_error(status_or_obj.status());
+        break;
+      }
+      if (status_or_obj.value() == nullptr) {
+        break;
+      }
+      if (!co_await streams_.push(std::move(status_or_obj).value())) {
+        break;
+      }
+    }
+    streams_.close();
+  }
+
+  /**
+   * @brief Parse streams from streams_ one after another and push their batches into batches_.
+   * The last lane to finish closes batches_.
+   */
+  Task<void> lane() {
+    TextLineParser parser(text_options_);
+    while (!stopping_) {
+      auto stream = co_await streams_.pop();
+      if (!stream.has_value()) {
+        break;
+      }
+      const uint64_t rows_filtered = parser.rows_filtered();
+      auto status = co_await parse_stream(*stream.value(), &parser);
+      rows_filtered_ += parser.rows_filtered() - rows_filtered;
+      if (!status.ok()) {
+        set_error(std::move(status));
+        break;
+      }
+    }
+    if (--lanes_running_ == 0) {
+      batches_.close();
+    }
+  }
+
+  Task<absl::Status> parse_stream(DataObject& stream, TextLineParser* parser) {
+    const bool inflate = stream.data_meta()->data_type() == typeid(InflateStream);
+    std::string pending_line;
+    while (!stopping_) {
+      std::span<const char> chunk;
+      try {
+        if (inflate) {
+          chunk = co_await stream.as<InflateStream>().read_chunk_async(scheduler_,
+                                                                       kInflateChunkSize);
+        } else {
+          chunk = co_await stream.as<ByteStream>().read_chunk_async(scheduler_);
+        }
+      } catch (const std::exception& e) {
+        co_return absl::UnavailableError(e.what());
+      }
+      if (chunk.empty()) {
+        break;
+      }
+
+      while (true) {
+        const char* newline =
+            static_cast<const char*>(std::memchr(chunk.data(), '\n', chunk.size()));
+        if (newline == nullptr) {
+          // 不完整的行，留到下一个 chunk 拼接
+          pending_line.append(chunk.data(), chunk.size());
+          break;
+        }
+        std::string_view line(chunk.data(), newline - chunk.data());
+        chunk = chunk.subspan(newline - chunk.data() + 1);
+        if (!pending_line.empty()) {
+          pending_line.append(line);
+          line = pending_line;
+        }
+        auto status = parse(parser, line);
+        pending_line.clear();
+        if (!status.ok()) {
+          co_return status;
+        }
+        if (parser->rows() >= batch_size_ && !co_await batches_.push(parser->finish_batch())) {
+          co_return absl::OkStatus();
+        }
+      }
+    }
+
+    // 流结束时最后一行可能没有换行符
+    auto status = parse(parser, pending_line);
+    if (!status.ok()) {
+      co_return status;
+    }
+    if (parser->rows() > 0) {
+      co_await batches_.push(parser->finish_batch());
+    }
+    co_return absl::OkStatus();
+  }
+
+  static absl::Status parse(TextLineParser* parser, std::string_view line) {
+    if (line.empty()) {
+      return absl::OkStatus();
+    }
+    return parser->parse_line(line).status();
+  }
+
+  // scheduler_ 最先构造、最后析构：其余成员析构时已没有协程运行
+  Scheduler scheduler_;
+  std::shared_ptr<DataPipeline> input_;
+  size_t batch_size_;
+  TextSampleOptions text_options_;
+  size_t num_lanes_;
+
+  Channel<std::shared_ptr<DataObject>> streams_;
+  Channel<std::shared_ptr<SampleBatch>> batches_;
+
+  std::once_flag started_;
+  std::atomic<bool> stopping_{false};
+  std::atomic<size_t> lanes_running_{0};
+  std::atomic<uint64_t> rows_filtered_{0};
+
+  std::mutex mutex_;
+  std::condition_variable done_cv_;
+  // 尚未结束的协程数，析构时等待其归零
+  size_t running_ = 0;
+  absl::Status error_;
+};
+}  // namespace data_flow
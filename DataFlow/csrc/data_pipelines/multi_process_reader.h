@@ -0,0 +1,267 @@
+/**
+ * @file multi_process_reader.h
+ * @brief Definition of MultiProcessReader pipeline running shards of a pipeline in worker
+ * processes and handing their batches over through shared memory.
+ *
+ * Author: Jasmine (1011694931@qq.com)
+ * Created on: 2025-11-14
+ *
+ * Copyright (c) 2025 Jasmine. All rights reserved.
+ */
+
+#pragma once
+
+#include <signal.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "glog/logging.h"
+#include "pybind11/pybind11.h"
+
+#include "DataFlow/csrc/common/threads.h"
+#include "DataFlow/csrc/core/data_object.h"
+#include "DataFlow/csrc/core/data_pipeline.h"
+#include "DataFlow/csrc/data_objects/sample_batch.h"
+#include "DataFlow/csrc/data_objects/shm_sample_batch.h"
+#include "DataFlow/csrc/ipc/shm_ring.h"
+
+namespace data_flow {
+
+/**
+ * @brief MultiProcessReader forks num_workers worker processes. Worker i builds its pipeline with
+ * `factory` from the files i, i + num_workers, ... and encodes every SampleBatch it produces into a
+ * free slot of a shared ShmRing. next() returns the batches as ShmSampleBatch, read in place;
+ * the slot is recycled when the ShmSampleBatch, and every numpy array viewing it, is released.
+ * When the caller holds all num_slots batches, next() fails with ResourceExhausted instead of
+ * waiting for a slot that is never released. ShmSampleBatch is not a SampleBatch, so the output
+ * cannot feed the pipelines transforming SampleBatch (GroupBatcher, SparseDedup, ...).
+ *
+ * A worker whose pipeline fails, or that dies (e.g. killed by a signal), is reported by next() as
+ * an Internal error naming the worker; the remaining workers keep running.
+ *
+ * Workers are forked in the constructor, which must run while no other DataFlow thread is running
+ * (the threads of FileDiscovery, ReadaheadReader, Scheduler, ...): a child would inherit the locks
+ * those threads hold and could deadlock on them. The constructor throws otherwise, so create the
+ * MultiProcessReader before the other pipelines, or after they are destroyed. Workers receive
+ * SIGKILL when the thread that constructed the reader exits (PR_SET_PDEATHSIG follows the forking
+ * thread, not the process), so construct it on a thread that outlives the reader, e.g. the main
+ * thread.
+ */
+class MultiProcessReader final : public DataPipeline {
+ public:
+  using PipelineFactory =
+      std::function<std::shared_ptr<DataPipeline>(std::vector<std::string> files)>;
+
+  MultiProcessReader(std::vector<std::string> files, size_t num_workers, PipelineFactory factory,
+                     const ShmRingOptions& ring_options = {}) {
+    CHECK_GT(num_workers, 0) << "num_workers must be positive";
+    if (const int64_t live = Threads::live(); live != 0) {
+      throw std::runtime_error(absl::StrFormat(
+          "MultiProcessReader forks its workers and must be created while no other DataFlow "
+          "thread is running, %d are: create it before the other pipelines",
+          live));
+    }
+    num_workers = std::min(num_workers, std::max<size_t>(files.size(), 1));
+
+    auto status_or_ring = ShmRing::Create(num_workers, ring_options);
+    if (!status_or_ring.ok()) {
+      throw std::runtime_error(std::string(status_or_ring.status().message()));
+    }
+    ring_ = std::move(status_or_ring).value();
+
+    for (size_t i = 0; i < num_workers; ++i) {
+      std::vector<std::string> shard;
+      for (size_t f = i; f < files.size(); f += num_workers) {
+        shard.push_back(files[f]);
+      }
+      pid_t parent = ::getpid();
+      pid_t pid = ::fork();
+      if (pid < 0) {
+        stop_workers();
+        throw std::runtime_error(absl::StrFormat("fork failed: %s", std::strerror(errno)));
+      }
+      if (pid == 0) {
+        RunWorker(ring_.get(), i, parent, factory, std::move(shard));
+      }
+      workers_.push_back(Worker{pid, true});
+      VLOG(3) << "[MultiProcessReader] worker " << i << " pid " << pid << ", "
+              << shard.size() << " files";
+    }
+  }
+
+  ~MultiProcessReader() final { stop_workers(); }
+
+  std::shared_ptr<DataObjectMeta> output_data_meta() const final {
+    static std::shared_ptr<DataObjectMeta> meta = std::make_shared<ShmSampleBatchMeta>();
+    return meta;
+  }
+
+  absl::StatusOr<std::shared_ptr<DataObject>> next() final {
+    while (true) {
+      // 先读取事件计数再扫描，避免扫描后、等待前发布的 slot 丢失唤醒
+      const uint32_t events = ring_->ready_events();
+      uint32_t slot = ring_->take();
+      if (slot != ShmRing::kNoSlot) {
+        return std::make_shared<ShmSampleBatch>(ring_, slot);
+      }
+
+      auto status = reap_workers();
+      if (!status.ok()) {
+        return status;
+      }
+      if (live_workers() == 0) {
+        // worker 退出前发布的 slot 已全部可见
+        slot = ring_->take();
+        if (slot != ShmRing::kNoSlot) {
+          return std::make_shared<ShmSampleBatch>(ring_, slot);
+        }
+        VLOG(3) << "[MultiProcessReader] all workers finished";
+        return nullptr;
+      }
+      if (ring_->all_reading()) {
+        // 所有 slot 都被尚未释放的 batch 占用，worker 无法再发布，等待会永远阻塞
+        return absl::ResourceExhaustedError(absl::StrFormat(
+            "All %d shared memory slots are held by batches not released yet: release or copy "
+            "the batches before asking for more, or raise num_slots",
+            ring_->num_slots()));
+      }
+      ring_->wait_ready(events, kPollIntervalMs);
+    }
+  }
+
+  PyObject* as_python_object(std::shared_ptr<DataObject> data_object) const final {
+    CHECK(data_object->data_meta()->data_type() == typeid(ShmSampleBatch))
+        << "DataObject is not of type ShmSampleBatch, got: "
+        << data_object->data_meta()->data_type().name();
+
+    auto batch_ptr = std::dynamic_pointer_cast<ShmSampleBatch>(data_object->shared_from_this());
+    return pybind11::cast(batch_ptr).release().ptr();
+  }
+
+  size_t num_workers() const { return workers_.size(); }
+
+ private:
+  // 等待数据时检查 worker 存活的周期
+  static constexpr int64_t kPollIntervalMs = 100;
+
+  struct Worker {
+    pid_t pid;
+    bool alive;
+  };
+
+  [[noreturn]] static void RunWorker(ShmRing* ring, uint32_t index, pid_t parent,
+                                     const PipelineFactory& factory,
+                                     std::vector<std::string> files) {
+    // 父进程中调用 fork 的线程退出时即发送 SIGKILL，而非整个父进程退出时
+    ::prctl(PR_SET_PDEATHSIG, SIGKILL);
+    if (::getppid() != parent) {
+      ::_exit(0);
+    }
+
+    auto fail = [&](std::string_view message) {
+      ring->set_worker_error(index, message);
+      ::_exit(1);
+    };
+    try {
+      auto pipeline = factory(std::move(files));
+      if (pipeline->output_data_meta()->data_type() != typeid(SampleBatch)) {
+        fail("worker pipeline must produce SampleBatch");
+      }
+      while (true) {
+        auto status_or_obj = pipeline->next();
+        if (!status_or_obj.ok()) {
+          fail(status_or_obj.status().ToString());
+        }
+        if (status_or_obj.value() == nullptr) {
+          break;
+        }
+        auto status_or_slot = ring->acquire(index);
+        if (!status_or_slot.ok()) {
+          break;  // 消费者已停止
+        }
+        auto status_or_size =
+            ShmSampleBatch::Encode(status_or_obj.value()->as<SampleBatch>(),
+                                   ring->slot_data(status_or_slot.value()), ring->slot_size());
+        if (!status_or_size.ok()) {
+          fail(status_or_size.status().ToString());
+        }
+        ring->publish(status_or_slot.value(), status_or_size.value());
+      }
+    } catch (const std::exception& e) {
+      fail(e.what());
+    }
+    ::_exit(0);
+  }
+
+  size_t live_workers() const {
+    size_t live = 0;
+    for (const auto& worker : workers_) {
+      live += worker.alive;
+    }
+    return live;
+  }
+
+  /**
+   * @brief Collect the workers that exited since the last call.
+   * @return Internal error for the first worker that failed or died.
+   */
+  absl::Status reap_workers() {
+    absl::Status status;
+    for (uint32_t i = 0; i < workers_.size(); ++i) {
+      auto& worker = workers_[i];
+      int wstatus = 0;
+      if (!worker.alive || ::waitpid(worker.pid, &wstatus, WNOHANG) != worker.pid) {
+        continue;
+      }
+      worker.alive = false;
+      if (WIFEXITED(wstatus) && WEXITSTATUS(wstatus) == 0) {
+        VLOG(3) << "[MultiProcessReader] worker " << i << " finished";
+        continue;
+      }
+
+      ring_->reclaim(i);
+      std::string reason;
+      if (WIFSIGNALED(wstatus)) {
+        reason = absl::StrFormat("was killed by signal %d (%s)", WTERMSIG(wstatus),
+                                 strsignal(WTERMSIG(wstatus)));
+      } else if (std::string error = ring_->worker_error(i); !error.empty()) {
+        reason = absl::StrFormat("failed: %s", error);
+      } else {
+        reason = absl::StrFormat("exited with code %d", WEXITSTATUS(wstatus));
+      }
+      LOG(ERROR) << "[MultiProcessReader] worker " << i << " (pid " << worker.pid << ") "
+                 << reason;
+      if (status.ok()) {
+        status = absl::InternalError(
+            absl::StrFormat("worker %d (pid %d) %s", i, worker.pid, reason));
+      }
+    }
+    return status;
+  }
+
+  void stop_workers() {
+    ring_->stop();
+    for (auto& worker : workers_) {
+      if (worker.alive) {
+        ::kill(worker.pid, SIGKILL);
+        ::waitpid(worker.pid, nullptr, 0);
+        worker.alive = false;
+      }
+    }
+  }
+
+  std::shared_ptr<ShmRing> ring_;
+  std::vector<Worker> workers_;
+};
+}  // namespace data_flow
@@ -0,0 +1,166 @@
+/**
+ * @file sparse_dedup.h
+ * @brief Definition of SparseDedup pipeline computing unique sparse ids and inverse indices.
+ *
+ * Author: Jasmine (1011694931@qq.com)
+ * Created on: 2025-11-15
+ *
+ * Copyright (c) 2025 Jasmine. All rights reserved.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "glog/logging.h"
+#include "pybind11/pybind11.h"
+
+#include "DataFlow/csrc/common/id_dedup_table.h"
+#include "DataFlow/csrc/core/data_object.h"
+#include "DataFlow/csrc/core/data_pipeline.h"
+#include "DataFlow/csrc/data_objects/sample_batch.h"
+
+namespace data_flow {
+
+/**
+ * @brief Counters of SparseDedup since its creation.
+ */
+struct DedupMetrics {
+  uint64_t batches = 0;
+  uint64_t ids = 0;
+  uint64_t unique_ids = 0;
+  uint64_t nanoseconds = 0;
+
+  // 平均每个 unique id 对应的 id 个数，即 embedding 查询量的缩减倍数
+  double dedup_ratio() const { return unique_ids == 0 ? 1.0 : double(ids) / unique_ids; }
+  double ns_per_id() const { return ids == 0 ? 0.0 : double(nanoseconds) / ids; }
+};
+
+/**
+ * @brief SparseDedup deduplicates the ids of the sparse columns of every SampleBatch of its input
+ * pipeline, so that the trainer looks up each embedding once per batch and gathers it back with the
+ * inverse index.
+ *
+ * - per slot (per_slot = true): column.unique_ids holds the distinct ids of the column in order of
+ *   first occurrence, and column.ids[i] == column.unique_ids[column.inverse[i]];
+ * - global (per_slot = false): one list SampleBatch::unique_ids() over all deduplicated columns,
+ *   and column.ids[i] == batch.unique_ids()[column.inverse[i]]. Equal ids of different slots share
+ *   an entry, which suits ids already made unique across slots (e.g. FG hash_mod with a salt).
+ *
+ * Only the columns of `slots` are deduplicated (every sparse column if unset). Batches are updated
+ * in place, so SparseDedup should run after the stages that rebuild batches (FG, GroupBatcher).
+ */
+class SparseDedup final : public DataPipeline {
+ public:
+  SparseDedup(const std::shared_ptr<DataPipeline>& data_pipeline,
+              std::optional<std::vector<int64_t>> slots = std::nullopt, bool per_slot = true)
+      : per_slot_(per_slot) {
+    CHECK(data_pipeline->output_data_meta()->data_type() == typeid(SampleBatch))
+        << "Input DataPipeline must produce SampleBatch, got: "
+        << data_pipeline->output_data_meta()->data_type().name();
+    input_ = data_pipeline;
+    if (slots.has_value()) {
+      slots_.emplace(slots->begin(), slots->end());
+    }
+  }
+
+  std::shared_ptr<DataObjectMeta> output_data_meta() const final {
+    static std::shared_ptr<DataObjectMeta> meta = std::make_shared<SampleBatchMeta>();
+    return meta;
+  }
+
+  absl::StatusOr<std::shared_ptr<DataObject>> next() final {
+    auto status_or_obj = input_->next();
+    if (!status_or_obj.ok()) {
+      return status_or_obj.status();
+    }
+
+    auto obj = status_or_obj.value();
+    if (obj == nullptr) {
+      VLOG(3) << "[SparseDedup] end of input pipeline, dedup ratio: " << metrics_.dedup_ratio()
+              << ", ns/id: " << metrics_.ns_per_id();
+      return nullptr;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    dedup(&obj->as<SampleBatch>());
+    metrics_.nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::steady_clock::now() - start)
+                                .count();
+    ++metrics_.batches;
+    return obj;
+  }
+
+  PyObject* as_python_object(std::shared_ptr<DataObject> data_object) const final {
+    CHECK(data_object->data_meta()->data_type() == typeid(SampleBatch))
+        << "DataObject is not of type SampleBatch, got: "
+        << data_object->data_meta()->data_type().name();
+
+    auto batch_ptr = std::dynamic_pointer_cast<SampleBatch>(data_object->shared_from_this());
+    return pybind11::cast(batch_ptr).release().ptr();
+  }
+
+  const DedupMetrics& metrics() const { return metrics_; }
+
+ private:
+  bool selected(const SparseColumn& column) const {
+    return !slots_.has_value() || slots_->contains(column.slot);
+  }
+
+  void dedup(SampleBatch* batch) {
+    auto& columns = batch->sparse_columns();
+    if (!per_slot_) {
+      size_t total = 0;
+      for (const auto& column : columns) {
+        total += selected(column) ? column.size() : 0;
+      }
+      auto& unique = batch->unique_ids();
+      unique.clear();
+      unique.reserve(total);
+      table_.reset(total);
+      for (auto& column : columns) {
+        if (selected(column)) {
+          column.unique_ids.clear();
+          dedup_column(&column, &unique);
+        }
+      }
+      metrics_.ids += total;
+      metrics_.unique_ids += unique.size();
+      return;
+    }
+
+    for (auto& column : columns) {
+      if (!selected(column)) {
+        continue;
+      }
+      column.unique_ids.clear();
+      column.unique_ids.reserve(column.size());
+      table_.reset(column.size());
+      dedup_column(&column, &column.unique_ids);
+      metrics_.ids += column.size();
+      metrics_.unique_ids += column.unique_ids.size();
+    }
+  }
+
+  void dedup_column(SparseColumn* column, std::vector<uint64_t>* unique) {
+    column->inverse.resize(column->size());
+    if (column->id_dtype == SparseIdDType::kUint32) {
+      table_.dedup(std::span<const uint32_t>(column->ids32), unique, column->inverse.data());
+    } else {
+      table_.dedup(std::span<const uint64_t>(column->ids), unique, column->inverse.data());
+    }
+  }
+
+  std::shared_ptr<DataPipeline> input_;
+  std::optional<absl::flat_hash_set<int64_t>> slots_;
+  bool per_slot_;
+
+  IdDedupTable table_;
+  DedupMetrics metrics_;
+};
+}  // namespace data_flow
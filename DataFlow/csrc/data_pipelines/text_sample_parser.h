@@ -0,0 +1,168 @@
+/**
+ * @file text_sample_parser.h
+ * @brief Definition of TextSampleParser pipeline turning text sample streams into SampleBatch.
+ *
+ * Author: Jasmine (1011694931@qq.com)
+ * Created on: 2025-11-9
+ *
+ * Copyright (c) 2025 Jasmine. All rights reserved.
+ */
+
+#pragma once
+
+#include <cstring>
+#include <span>
+#include <string>
+
+#include "glog/logging.h"
+#include "pybind11/pybind11.h"
+
+#include "DataFlow/csrc/core/data_object.h"
+#include "DataFlow/csrc/core/data_pipeline.h"
+#include "DataFlow/csrc/data_objects/byte_stream.h"
+#include "DataFlow/csrc/data_objects/inflate_stream.h"
+#include "DataFlow/csrc/data_objects/sample_batch.h"
+#include "DataFlow/csrc/parsers/text_line_parser.h"
+
+namespace data_flow {
+
+/**
+ * @brief TextSampleParser splits the streams of its input pipeline (ByteStream or InflateStream)
+ * into lines and parses them into SampleBatch of at most batch_size rows. Batches span stream
+ * boundaries; only the last batch may be smaller.
+ */
+class TextSampleParser final : public DataPipeline {
+ public:
+  TextSampleParser(const std::shared_ptr<DataPipeline>& data_pipeline, size_t batch_size,
+                   const TextSampleOptions& options = {})
+      : batch_size_(batch_size), parser_(options) {
+    auto input_type = data_pipeline->output_data_meta()->data_type();
+    CHECK(input_type == typeid(ByteStream) || input_type == typeid(InflateStream))
+        << "Input DataPipeline must produce ByteStream or InflateStream, got: "
+        << input_type.name();
+    CHECK_GT(batch_size_, 0) << "batch_size must be positive";
+    input_ = data_pipeline;
+  }
+
+  std::shared_ptr<DataObjectMeta> output_data_meta() const final {
+    static std::shared_ptr<DataObjectMeta> meta = std::make_shared<SampleBatchMeta>();
+    return meta;
+  }
+
+  absl::StatusOr<std::shared_ptr<DataObject>> next() final {
+    while (parser_.rows() < batch_size_) {
+      if (chunk_.empty()) {
+        auto status_or_more = read_more();
+        if (!status_or_more.ok()) {
+          return status_or_more.status();
+        }
+        if (!status_or_more.value()) {
+          break;  // 输入结束
+        }
+        continue;
+      }
+
+      const char* newline =
+          static_cast<const char*>(std::memchr(chunk_.data(), '\n', chunk_.size()));
+      if (newline == nullptr) {
+        // 不完整的行，留到下一个 chunk 拼接
+        pending_line_.append(chunk_.data(), chunk_.size());
+        chunk_ = {};
+        continue;
+      }
+
+      std::string_view line(chunk_.data(), newline - chunk_.data());
+      chunk_ = chunk_.subspan(newline - chunk_.data() + 1);
+      if (!pending_line_.empty()) {
+        pending_line_.append(line);
+        auto status = parse(pending_line_);
+        pending_line_.clear();
+        if (!status.ok()) {
+          return status;
+        }
+      } else {
+        auto status = parse(line);
+        if (!status.ok()) {
+          return status;
+        }
+      }
+    }
+
+    if (parser_.rows() == 0) {
+      VLOG(3) << "[TextSampleParser] end of input pipeline, rows filtered: "
+              << parser_.rows_filtered();
+      return nullptr;
+    }
+    return std::shared_ptr<DataObject>(parser_.finish_batch());
+  }
+
+  PyObject* as_python_object(std::shared_ptr<DataObject> data_object) const final {
+    CHECK(data_object->data_meta()->data_type() == typeid(SampleBatch))
+        << "DataObject is not of type SampleBatch, got: "
+        << data_object->data_meta()->data_type().name();
+
+    auto batch_ptr = std::dynamic_pointer_cast<SampleBatch>(data_object->shared_from_this());
+    return pybind11::cast(batch_ptr).release().ptr();
+  }
+
+  /**
+   * @brief Number of rows rejected by the row predicate so far.
+   */
+  uint64_t rows_filtered() const { return parser_.rows_filtered(); }
+
+ private:
+  static constexpr size_t kInflateChunkSize = 1 << 20;  // 1 MB
+
+  absl::Status parse(std::string_view line) {
+    if (line.empty()) {
+      return absl::OkStatus();
+    }
+    return parser_.parse_line(line).status();
+  }
+
+  /**
+   * @brief Fill chunk_ with the next chunk of the current stream, moving to the next stream of the
+   * input pipeline when the current one is exhausted.
+   * @return false if the input pipeline is exhausted.
+   */
+  absl::StatusOr<bool> read_more() {
+    while (true) {
+      if (stream_ != nullptr) {
+        chunk_ = stream_->data_meta()->data_type() == typeid(InflateStream)
+                     ? stream_->as<InflateStream>().read_chunk(kInflateChunkSize)
+                     : stream_->as<ByteStream>().read_chunk();
+        if (!chunk_.empty()) {
+          return true;
+        }
+        // 流结束时最后一行可能没有换行符
+        stream_ = nullptr;
+        if (!pending_line_.empty()) {
+          auto status = parse(pending_line_);
+          pending_line_.clear();
+          if (!status.ok()) {
+            return status;
+          }
+          return true;
+        }
+      }
+
+      auto status_or_obj = input_->next();
+      if (!status_or_obj.ok()) {
+        return status_or_obj.status();
+      }
+      stream_ = status_or_obj.value();
+      if (stream_ == nullptr) {
+        return false;
+      }
+    }
+  }
+
+  std::shared_ptr<DataPipeline> input_;
+  size_t batch_size_;
+  TextLineParser parser_;
+
+  std::shared_ptr<DataObject> stream_;
+  std::span<const char> chunk_;
+  std::string pending_line_;
+};
+}  // namespace data_flow
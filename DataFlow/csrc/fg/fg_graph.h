@@ -0,0 +1,286 @@
+/**
+ * @file fg_graph.h
+ * @brief Compilation of FG specs into a DAG of batch kernels and its execution.
+ *
+ * Author: Jasmine (1011694931@qq.com)
+ * Created on: 2025-11-8
+ *
+ * Copyright (c) 2025 Jasmine. All rights reserved.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+
+#include "DataFlow/csrc/data_objects/sample_batch.h"
+#include "fg_kernels.h"
+#include "fg_spec.h"
+
+namespace data_flow {
+
+/**
+ * @brief FgGraph is a FG spec compiled once into a DAG of batch kernels. Every op is validated at
+ * compile time, ops consuming the output of other ops are ordered after them, and run() executes
+ * the kernels in that order over whole columns of a SampleBatch.
+ */
+class FgGraph {
+ public:
+  using ColumnKey = std::pair<FgColumnKind, int64_t>;
+
+  /**
+   * @brief Validate the spec and order its ops topologically. An op may write its own input slot
+   * (e.g. hash_mod of slot 5 into slot 5); it then reads the column of the input batch.
+   * @return The compiled graph, or InvalidArgument if an op is malformed, two ops write the same
+   * column or the ops form a cycle.
+   */
+  static absl::StatusOr<FgGraph> Compile(const std::vector<FgOpSpec>& specs) {
+    FgGraph graph;
+
+    for (size_t i = 0; i < specs.size(); ++i) {
+      auto status = validate(specs[i]);
+      if (!status.ok()) {
+        return absl::InvalidArgumentError(absl::StrFormat(
+            "FG op #%d (%s): %s", i, FgOpTypeName(specs[i].type), status.message()));
+      }
+      ColumnKey key{FgOutputKind(specs[i].type), specs[i].output};
+      if (!graph.producers_.emplace(key, i).second) {
+        return absl::InvalidArgumentError(
+            absl::StrFormat("FG op #%d writes slot %d which is already written by op #%d", i,
+                            specs[i].output, graph.producers_[key]));
+      }
+    }
+
+    // 拓扑排序：依赖的 op 先执行，无依赖关系时保持 spec 中的顺序
+    std::vector<bool> scheduled(specs.size(), false);
+    while (graph.ops_.size() < specs.size()) {
+      bool progressed = false;
+      for (size_t i = 0; i < specs.size(); ++i) {
+        if (scheduled[i] || !graph.ready(i, specs[i], scheduled)) {
+          continue;
+        }
+        scheduled[i] = true;
+        graph.ops_.push_back(specs[i]);
+        progressed = true;
+      }
+      if (!progressed) {
+        return absl::InvalidArgumentError("FG ops form a cycle");
+      }
+    }
+    return graph;
+  }
+
+  /**
+   * @brief Ops in execution order.
+   */
+  const std::vector<FgOpSpec>& ops() const { return ops_; }
+
+  /**
+   * @brief Whether the column is written by an op of this graph.
+   */
+  bool produces(FgColumnKind kind, int64_t slot) const {
+    return producers_.contains(ColumnKey{kind, slot});
+  }
+
+  /**
+   * @brief Run the graph over a batch.
+   * @param input The batch to transform.
+   * @param keep_inputs Whether the columns of the input batch are copied to the output batch.
+   * Input columns with the same slot as a generated column are dropped.
+   * @return A new batch with the per-sample fields of input and the generated columns.
+   */
+  absl::StatusOr<std::shared_ptr<SampleBatch>> run(const SampleBatch& input,
+                                                   bool keep_inputs) const {
+    auto output = std::make_shared<SampleBatch>();
+    output->copy_sample_fields(input);
+
+    for (const auto& op : ops_) {
+      auto status = run_op(op, input, output.get());
+      if (!status.ok()) {
+        return status;
+      }
+    }
+
+    if (keep_inputs) {
+      for (const auto& column : input.sparse_columns()) {
+        if (!produces(FgColumnKind::kSparse, column.slot)) {
+          output->sparse_columns().push_back(column);
+        }
+      }
+      for (const auto& column : input.dense_columns()) {
+        if (!produces(FgColumnKind::kDense, column.slot)) {
+          output->dense_columns().push_back(column);
+        }
+      }
+    }
+    return output;
+  }
+
+ private:
+  static absl::Status validate(const FgOpSpec& op) {
+    if (op.inputs.size() != FgInputKinds(op.type).size()) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "expected %d inputs, got %d", FgInputKinds(op.type).size(), op.inputs.size()));
+    }
+    switch (op.type) {
+      case FgOpType::kHashMod:
+        if (op.num_buckets == 0) {
+          return absl::InvalidArgumentError("num_buckets must be positive");
+        }
+        break;
+      case FgOpType::kBucketize:
+        if (op.boundaries.empty()) {
+          return absl::InvalidArgumentError("boundaries must not be empty");
+        }
+        if (std::any_of(op.boundaries.begin(), op.boundaries.end(),
+                        [](float b) { return std::isnan(b); }) ||
+            !std::is_sorted(op.boundaries.begin(), op.boundaries.end())) {
+          return absl::InvalidArgumentError("boundaries must be sorted in ascending order");
+        }
+        break;
+      case FgOpType::kClip:
+        if (!(op.min_value <= op.max_value)) {
+          return absl::InvalidArgumentError("min_value must not be greater than max_value");
+        }
+        break;
+      case FgOpType::kTruncate:
+        if (op.max_length == 0) {
+          return absl::InvalidArgumentError("max_length must be positive");
+        }
+        break;
+      default:
+        break;
+    }
+    return absl::OkStatus();
+  }
+
+  bool ready(size_t index, const FgOpSpec& op, const std::vector<bool>& scheduled) const {
+    auto kinds = FgInputKinds(op.type);
+    for (size_t i = 0; i < op.inputs.size(); ++i) {
+      auto it = producers_.find(ColumnKey{kinds[i], op.inputs[i]});
+      // 原地改写的 op 读取输入 batch 中的列，不依赖自身
+      if (it != producers_.end() && it->second != index && !scheduled[it->second]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Whether the input slot of op is the column op itself writes.
+   */
+  static bool in_place(const FgOpSpec& op, FgColumnKind kind, int64_t slot) {
+    return FgOutputKind(op.type) == kind && op.output == slot;
+  }
+
+  /**
+   * @brief Resolve a sparse input of op: generated columns first, then the input batch. A slot
+   * missing from the batch is treated as a column with no ids.
+   */
+  const SparseColumn* sparse_input(const FgOpSpec& op, int64_t slot, const SampleBatch& input,
+                                   const SampleBatch& output, SparseColumn* empty) const {
+    const SparseColumn* column =
+        produces(FgColumnKind::kSparse, slot) && !in_place(op, FgColumnKind::kSparse, slot)
+            ? output.find_sparse(slot)
+            : input.find_sparse(slot);
+    if (column == nullptr) {
+      empty->slot = slot;
+      empty->offsets.assign(input.rows() + 1, 0);
+      column = empty;
+    }
+    return column;
+  }
+
+  const DenseColumn* dense_input(const FgOpSpec& op, int64_t slot, const SampleBatch& input,
+                                 const SampleBatch& output) const {
+    return produces(FgColumnKind::kDense, slot) && !in_place(op, FgColumnKind::kDense, slot)
+               ? output.find_dense(slot)
+               : input.find_dense(slot);
+  }
+
+  // FG 算子只处理 uint64 id 与 float32 值，紧凑类型需在 FG 之后的阶段使用
+  static absl::Status unsupported_dtype(const FgOpSpec& op, int64_t slot) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "FG op %s: slot %d has a compact dtype, FG needs uint64 ids and float32 values",
+        FgOpTypeName(op.type), slot));
+  }
+
+  absl::Status run_op(const FgOpSpec& op, const SampleBatch& input, SampleBatch* output) const {
+    SparseColumn empty_a, empty_b;
+
+    switch (op.type) {
+      case FgOpType::kHashMod:
+      case FgOpType::kTruncate:
+      case FgOpType::kCross: {
+        const SparseColumn* a = sparse_input(op, op.inputs[0], input, *output, &empty_a);
+        if (a->id_dtype != SparseIdDType::kUint64) {
+          return unsupported_dtype(op, a->slot);
+        }
+        SparseColumn column;
+        column.slot = op.output;
+        if (op.type == FgOpType::kHashMod) {
+          FgHashMod(*a, op.num_buckets, op.salt, &column);
+        } else if (op.type == FgOpType::kTruncate) {
+          FgTruncate(*a, op.max_length, op.keep_last, &column);
+        } else {
+          const SparseColumn* b = sparse_input(op, op.inputs[1], input, *output, &empty_b);
+          if (b->id_dtype != SparseIdDType::kUint64) {
+            return unsupported_dtype(op, b->slot);
+          }
+          // offsets 为 uint32，交叉结果过大时报错而不是回绕
+          const uint64_t size = FgCrossSize(*a, *b);
+          if (size > std::numeric_limits<uint32_t>::max()) {
+            return absl::InvalidArgumentError(absl::StrFormat(
+                "FG op %s: crossing slots %d and %d yields %d ids, more than %d per batch",
+                FgOpTypeName(op.type), a->slot, b->slot, size,
+                std::numeric_limits<uint32_t>::max()));
+          }
+          FgCross(*a, *b, op.num_buckets, op.salt, &column);
+        }
+        output->sparse_columns().push_back(std::move(column));
+      } break;
+      case FgOpType::kBucketize:
+      case FgOpType::kLog:
+      case FgOpType::kClip: {
+        const DenseColumn* in = dense_input(op, op.inputs[0], input, *output);
+        if (in == nullptr) {
+          return absl::NotFoundError(absl::StrFormat("FG op %s: dense slot %d not found in batch",
+                                                     FgOpTypeName(op.type), op.inputs[0]));
+        }
+        if (in->dtype != DenseDType::kFloat32) {
+          return unsupported_dtype(op, in->slot);
+        }
+        if (op.type == FgOpType::kBucketize) {
+          SparseColumn column;
+          column.slot = op.output;
+          FgBucketize(*in, op.boundaries, &column);
+          output->sparse_columns().push_back(std::move(column));
+        } else {
+          DenseColumn column;
+          column.slot = op.output;
+          if (op.type == FgOpType::kLog) {
+            FgLog(*in, &column);
+          } else {
+            FgClip(*in, op.min_value, op.max_value, &column);
+          }
+          output->dense_columns().push_back(std::move(column));
+        }
+      } break;
+    }
+    return absl::OkStatus();
+  }
+
+  std::vector<FgOpSpec> ops_;
+  absl::flat_hash_map<ColumnKey, size_t> producers_;
+};
+
+}  // namespace data_flow
@@ -0,0 +1,188 @@
+/**
+ * @file fg_kernels.h
+ * @brief Batch kernels implementing the FG transforms over whole sparse/dense columns.
+ *
+ * Author: Jasmine (1011694931@qq.com)
+ * Created on: 2025-11-8
+ *
+ * Copyright (c) 2025 Jasmine. All rights reserved.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "DataFlow/csrc/common/functions.h"
+#include "DataFlow/csrc/data_objects/sample_batch.h"
+
+namespace data_flow {
+
+/**
+ * @brief Map a 64-bit hash to [0, num_buckets) with a multiply-shift instead of a division.
+ * The result is uniform for well mixed hashes and costs a single multiplication per id.
+ */
+inline uint64_t FgReduce(uint64_t hash, uint64_t num_buckets) {
+  return static_cast<uint64_t>((static_cast<unsigned __int128>(hash) * num_buckets) >> 64);
+}
+
+/**
+ * @brief Hash every id of a sparse column into num_buckets buckets. Weights and row offsets are
+ * kept as is.
+ */
+inline void FgHashMod(const SparseColumn& in, uint64_t num_buckets, uint64_t salt,
+                      SparseColumn* out) {
+  const size_t n = in.ids.size();
+  out->ids.resize(n);
+  out->weights = in.weights;
+  out->offsets = in.offsets;
+
+  const uint64_t* __restrict src = in.ids.data();
+  uint64_t* __restrict dst = out->ids.data();
+  for (size_t i = 0; i < n; ++i) {
+    dst[i] = FgReduce(Func::mix64(src[i] ^ salt), num_buckets);
+  }
+}
+
+/**
+ * @brief Bucketize every value of a dense column. Row i of the output holds the bucket ids of the
+ * width values of row i, all with weight 1.
+ */
+inline void FgBucketize(const DenseColumn& in, const std::vector<float>& boundaries,
+                        SparseColumn* out) {
+  const size_t n = in.values.size();
+  const size_t rows = in.rows();
+  out->ids.resize(n);
+  out->weights.assign(n, 1.0f);
+  out->offsets.resize(rows + 1);
+  for (size_t r = 0; r <= rows; ++r) {
+    out->offsets[r] = static_cast<uint32_t>(r * in.width);
+  }
+
+  const float* __restrict src = in.values.data();
+  uint64_t* __restrict dst = out->ids.data();
+  const float* bounds = boundaries.data();
+  const size_t num_bounds = boundaries.size();
+
+  // 边界较少时按比较结果累加，无分支且可向量化；边界较多时二分查找
+  static constexpr size_t kLinearScanLimit = 16;
+  if (num_bounds <= kLinearScanLimit) {
+    for (size_t i = 0; i < n; ++i) {
+      const float x = src[i];
+      uint64_t bucket = 0;
+      for (size_t b = 0; b < num_bounds; ++b) {
+        bucket += static_cast<uint64_t>(x >= bounds[b]);
+      }
+      dst[i] = bucket;
+    }
+  } else {
+    for (size_t i = 0; i < n; ++i) {
+      dst[i] = std::upper_bound(bounds, bounds + num_bounds, src[i]) - bounds;
+    }
+  }
+}
+
+/**
+ * @brief value = log1p(max(value, 0)) for every value of a dense column.
+ */
+inline void FgLog(const DenseColumn& in, DenseColumn* out) {
+  const size_t n = in.values.size();
+  out->width = in.width;
+  out->values.resize(n);
+
+  const float* __restrict src = in.values.data();
+  float* __restrict dst = out->values.data();
+  for (size_t i = 0; i < n; ++i) {
+    dst[i] = std::log1p(std::max(src[i], 0.0f));
+  }
+}
+
+/**
+ * @brief value = clamp(value, min_value, max_value) for every value of a dense column.
+ */
+inline void FgClip(const DenseColumn& in, float min_value, float max_value, DenseColumn* out) {
+  const size_t n = in.values.size();
+  out->width = in.width;
+  out->values.resize(n);
+
+  const float* __restrict src = in.values.data();
+  float* __restrict dst = out->values.data();
+  for (size_t i = 0; i < n; ++i) {
+    dst[i] = std::min(std::max(src[i], min_value), max_value);
+  }
+}
+
+/**
+ * @brief Number of ids FgCross(a, b) produces, the sum over rows of len_a * len_b.
+ */
+inline uint64_t FgCrossSize(const SparseColumn& a, const SparseColumn& b) {
+  uint64_t size = 0;
+  for (size_t r = 0; r < a.rows(); ++r) {
+    const uint64_t len_a = a.offsets[r + 1] - a.offsets[r];
+    const uint64_t len_b = b.offsets[r + 1] - b.offsets[r];
+    size += len_a * len_b;
+  }
+  return size;
+}
+
+/**
+ * @brief Cross two sparse columns row by row. Every pair (a, b) of row i produces the id
+ * hash(a, b) with weight w(a) * w(b). If num_buckets is 0 the full 64-bit hash is kept.
+ * FgCrossSize(a, b) must fit in the uint32 offsets.
+ */
+inline void FgCross(const SparseColumn& a, const SparseColumn& b, uint64_t num_buckets,
+                    uint64_t salt, SparseColumn* out) {
+  const size_t rows = a.rows();
+  out->offsets.resize(rows + 1);
+  out->offsets[0] = 0;
+  for (size_t r = 0; r < rows; ++r) {
+    const uint64_t len_a = a.offsets[r + 1] - a.offsets[r];
+    const uint64_t len_b = b.offsets[r + 1] - b.offsets[r];
+    out->offsets[r + 1] = static_cast<uint32_t>(out->offsets[r] + len_a * len_b);
+  }
+  out->ids.resize(out->offsets[rows]);
+  out->weights.resize(out->offsets[rows]);
+
+  uint64_t* __restrict ids = out->ids.data();
+  float* __restrict weights = out->weights.data();
+  for (size_t r = 0; r < rows; ++r) {
+    size_t k = out->offsets[r];
+    for (uint32_t i = a.offsets[r]; i < a.offsets[r + 1]; ++i) {
+      const uint64_t ha = Func::mix64(a.ids[i] ^ salt);
+      const float wa = a.weights[i];
+      for (uint32_t j = b.offsets[r]; j < b.offsets[r + 1]; ++j, ++k) {
+        const uint64_t h = Func::mix64(ha ^ (b.ids[j] + 0x9e3779b97f4a7c15ULL + (ha << 6)));
+        ids[k] = num_buckets == 0 ? h : FgReduce(h, num_buckets);
+        weights[k] = wa * b.weights[j];
+      }
+    }
+  }
+}
+
+/**
+ * @brief Keep at most max_length ids of every row of a sparse column, either the first ones or,
+ * if keep_last is set, the last ones.
+ */
+inline void FgTruncate(const SparseColumn& in, uint32_t max_length, bool keep_last,
+                       SparseColumn* out) {
+  const size_t rows = in.rows();
+  out->offsets.resize(rows + 1);
+  out->offsets[0] = 0;
+  for (size_t r = 0; r < rows; ++r) {
+    const uint32_t len = in.offsets[r + 1] - in.offsets[r];
+    out->offsets[r + 1] = out->offsets[r] + std::min(len, max_length);
+  }
+  out->ids.resize(out->offsets[rows]);
+  out->weights.resize(out->offsets[rows]);
+
+  for (size_t r = 0; r < rows; ++r) {
+    const uint32_t kept = out->offsets[r + 1] - out->offsets[r];
+    const uint32_t begin = keep_last ? in.offsets[r + 1] - kept : in.offsets[r];
+    std::copy_n(in.ids.data() + begin, kept, out->ids.data() + out->offsets[r]);
+    std::copy_n(in.weights.data() + begin, kept, out->weights.data() + out->offsets[r]);
+  }
+}
+
+}  // namespace data_flow
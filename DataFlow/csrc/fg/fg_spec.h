@@ -0,0 +1,128 @@
+/**
+ * @file fg_spec.h
+ * @brief Declarative specification of feature generation (FG) transforms.
+ *
+ * Author: Jasmine (1011694931@qq.com)
+ * Created on: 2025-11-8
+ *
+ * Copyright (c) 2025 Jasmine. All rights reserved.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+
+namespace data_flow {
+
+/**
+ * @brief Kind of a column referenced by a FG transform.
+ */
+enum class FgColumnKind : int8_t { kSparse, kDense };
+
+/**
+ * @brief Supported FG transforms.
+ *
+ * - kHashMod:   sparse -> sparse, id = hash(id ^ salt) reduced to [0, num_buckets).
+ * - kBucketize: dense  -> sparse, one bucket id per dense value, bucket i covers
+ *               [boundaries[i - 1], boundaries[i]).
+ * - kLog:       dense  -> dense, value = log1p(max(value, 0)).
+ * - kClip:      dense  -> dense, value = clamp(value, min_value, max_value).
+ * - kCross:     sparse x sparse -> sparse, cartesian product of the two slots of each row.
+ * - kTruncate:  sparse -> sparse, keep at most max_length ids of each row.
+ */
+enum class FgOpType : int8_t { kHashMod, kBucketize, kLog, kClip, kCross, kTruncate };
+
+/**
+ * @brief FgOpSpec describes one transform: which slots it reads, which slot it writes and the
+ * parameters of the transform. Parameters that do not apply to the op type are ignored.
+ */
+struct FgOpSpec {
+  FgOpType type = FgOpType::kHashMod;
+  std::vector<int64_t> inputs;
+  int64_t output = 0;
+
+  // kHashMod, kCross: number of output buckets, 0 keeps the full 64-bit hash (kCross only).
+  uint64_t num_buckets = 0;
+  // kHashMod, kCross: salt mixed into the hash so different features do not share buckets.
+  uint64_t salt = 0;
+  // kBucketize: ascending bucket boundaries.
+  std::vector<float> boundaries;
+  // kClip: clamp range.
+  float min_value = std::numeric_limits<float>::lowest();
+  float max_value = std::numeric_limits<float>::max();
+  // kTruncate: maximum number of ids per row, keep the last ids instead of the first ones.
+  uint32_t max_length = 0;
+  bool keep_last = false;
+};
+
+/**
+ * @brief Parse a FG op type from its name, e.g. "hash_mod", "bucketize", "log", "clip", "cross",
+ * "truncate".
+ */
+inline absl::StatusOr<FgOpType> FgOpTypeFromName(std::string_view name) {
+  if (name == "hash_mod") return FgOpType::kHashMod;
+  if (name == "bucketize") return FgOpType::kBucketize;
+  if (name == "log") return FgOpType::kLog;
+  if (name == "clip") return FgOpType::kClip;
+  if (name == "cross") return FgOpType::kCross;
+  if (name == "truncate") return FgOpType::kTruncate;
+  return absl::InvalidArgumentError(absl::StrFormat("Unknown FG op: %s", name));
+}
+
+inline const char* FgOpTypeName(FgOpType type) {
+  switch (type) {
+    case FgOpType::kHashMod:
+      return "hash_mod";
+    case FgOpType::kBucketize:
+      return "bucketize";
+    case FgOpType::kLog:
+      return "log";
+    case FgOpType::kClip:
+      return "clip";
+    case FgOpType::kCross:
+      return "cross";
+    case FgOpType::kTruncate:
+      return "truncate";
+  }
+  return "unknown";
+}
+
+/**
+ * @brief Column kinds read by an op, in input order.
+ */
+inline std::vector<FgColumnKind> FgInputKinds(FgOpType type) {
+  switch (type) {
+    case FgOpType::kHashMod:
+    case FgOpType::kTruncate:
+      return {FgColumnKind::kSparse};
+    case FgOpType::kBucketize:
+    case FgOpType::kLog:
+    case FgOpType::kClip:
+      return {FgColumnKind::kDense};
+    case FgOpType::kCross:
+      return {FgColumnKind::kSparse, FgColumnKind::kSparse};
+  }
+  return {};
+}
+
+/**
+ * @brief Column kind written by an op.
+ */
+inline FgColumnKind FgOutputKind(FgOpType type) {
+  switch (type) {
+    case FgOpType::kLog:
+    case FgOpType::kClip:
+      return FgColumnKind::kDense;
+    default:
+      return FgColumnKind::kSparse;
+  }
+}
+
+}  // namespace data_flow
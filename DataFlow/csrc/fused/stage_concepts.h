@@ -0,0 +1,84 @@
+/**
+ * @file stage_concepts.h
+ * @brief Concepts of statically composed pipeline stages and the Fuse composition alias.
+ *
+ * Author: Jasmine (1011694931@qq.com)
+ * Created on: 2025-11-13
+ *
+ * Copyright (c) 2025 Jasmine. All rights reserved.
+ */
+
+#pragma once
+
+#include <concepts>
+#include <memory>
+#include <span>
+#include <string_view>
+
+#include "absl/status/statusor.h"
+
+#include "DataFlow/csrc/data_objects/sample_batch.h"
+
+namespace data_flow {
+
+/**
+ * Fused stages are plain classes holding their upstream stage by value, with non-virtual methods.
+ * Fuse<Source, Stage1, Stage2, ...> is Stage2<Stage1<Source>>: a stage declares the kind of
+ * upstream it accepts with a concept, so a wrong composition fails to compile, and the compiler
+ * sees the whole chain and inlines it into the loop of the last stage.
+ */
+
+/**
+ * @brief A sequence of byte streams (files), read in chunks.
+ *
+ * - open_next(): move to the next stream, false once every stream has been read;
+ * - read(): next chunk of the current stream, empty at the end of the stream. The chunk stays valid
+ *   until the next call.
+ */
+template <typename S>
+concept ByteSource = requires(S& s) {
+  { s.open_next() } -> std::same_as<absl::StatusOr<bool>>;
+  { s.read() } -> std::same_as<absl::StatusOr<std::span<const char>>>;
+};
+
+/**
+ * @brief A sequence of lines without their newline.
+ *
+ * - read_lines(sink): call sink(line) for the next lines until sink returns false or the input is
+ *   exhausted. Returns false once the input is exhausted. The line is only valid during the call.
+ */
+template <typename S>
+concept LineSource = requires(S& s) {
+  { s.read_lines([](std::string_view) { return true; }) } -> std::same_as<absl::StatusOr<bool>>;
+};
+
+/**
+ * @brief A sequence of SampleBatch; next_batch() returns nullptr once the input is exhausted.
+ */
+template <typename S>
+concept BatchSource = requires(S& s) {
+  { s.next_batch() } -> std::same_as<absl::StatusOr<std::shared_ptr<SampleBatch>>>;
+};
+
+namespace internal {
+template <typename Source, template <typename> class... Stages>
+struct Fuse;
+
+template <typename Source>
+struct Fuse<Source> {
+  using type = Source;
+};
+
+template <typename Source, template <typename> class Stage, template <typename> class... Rest>
+struct Fuse<Source, Stage, Rest...> {
+  using type = typename Fuse<Stage<Source>, Rest...>::type;
+};
+}  // namespace internal
+
+/**
+ * @brief Fuse<Source, A, B, C> is C<B<A<Source>>>.
+ */
+template <typename Source, template <typename> class... Stages>
+using Fuse = typename internal::Fuse<Source, Stages...>::type;
+
+}  // namespace data_flow
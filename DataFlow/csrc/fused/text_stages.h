@@ -0,0 +1,297 @@
+/**
+ * @file text_stages.h
+ * @brief Fused stages reading text sample files: FileSource, Inflate, LineSplit and Parse.
+ *
+ * Author: Jasmine (1011694931@qq.com)
+ * Created on: 2025-11-13
+ *
+ * Copyright (c) 2025 Jasmine. All rights reserved.
+ */
+
+#pragma once
+
+#include <cstring>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "zlib.h"
+
+#include "DataFlow/csrc/data_objects/byte_stream.h"
+#include "DataFlow/csrc/data_objects/sample_batch.h"
+#include "DataFlow/csrc/fused/stage_concepts.h"
+#include "DataFlow/csrc/io/file_system_registry.h"
+#include "DataFlow/csrc/io/readahead_reader.h"
+#include "DataFlow/csrc/parsers/text_line_parser.h"
+
+namespace data_flow {
+
+/**
+ * @brief ByteSource over a list of files, read in order. Remote uris ("http://", "hdfs://", ...)
+ * are read through a ReadaheadReader, local paths and "file://" uris sequentially.
+ */
+class FileSource {
+ public:
+  static constexpr size_t kDefaultBufferSize = 1 << 20;  // 1 MB
+
+  explicit FileSource(std::vector<std::string> files, size_t buffer_size = kDefaultBufferSize)
+      : files_(std::move(files)), buffer_size_(buffer_size) {}
+
+  absl::StatusOr<bool> open_next() {
+    stream_.reset();
+    if (next_file_ == files_.size()) {
+      return false;
+    }
+    const std::string& file = files_[next_file_++];
+    if (FileSystemRegistry::Instance().is_remote(file)) {
+      auto status_or_file = FileSystemRegistry::Instance().open(file);
+      if (!status_or_file.ok()) {
+        return status_or_file.status();
+      }
+      stream_ = std::make_unique<ByteStream>(
+          std::make_unique<ReadaheadReader>(std::move(status_or_file).value()), buffer_size_);
+      return true;
+    }
+    try {
+      stream_ = std::make_unique<ByteStream>(std::string(file), buffer_size_);
+    } catch (const std::runtime_error& e) {
+      return absl::NotFoundError(e.what());
+    }
+    return true;
+  }
+
+  absl::StatusOr<std::span<const char>> read() {
+    if (stream_ == nullptr) {
+      return std::span<const char>{};
+    }
+    try {
+      return stream_->read_chunk();
+    } catch (const std::runtime_error& e) {
+      // 远程文件的 range 读取在重试后仍失败
+      return absl::UnavailableError(e.what());
+    }
+  }
+
+ private:
+  std::vector<std::string> files_;
+  size_t buffer_size_;
+  size_t next_file_ = 0;
+  std::unique_ptr<ByteStream> stream_;
+};
+
+/**
+ * @brief ByteSource decompressing the gzip/zlib streams of its upstream. Concatenated gzip members
+ * in one file are decompressed one after the other, like gzip -d does.
+ */
+template <ByteSource Upstream>
+class Inflate {
+ public:
+  static constexpr size_t kDefaultChunkSize = 1 << 20;  // 1 MB
+
+  explicit Inflate(Upstream upstream, size_t chunk_size = kDefaultChunkSize)
+      : upstream_(std::move(upstream)), chunk_size_(chunk_size), output_(new char[chunk_size]) {
+    z_stream_ = {};
+    // 32: 自动识别 gzip/zlib 头
+    CHECK_EQ(inflateInit2(&z_stream_, 32 | 15), Z_OK) << "Failed to initialize zlib inflate stream";
+  }
+
+  ~Inflate() {
+    if (output_ != nullptr) {
+      inflateEnd(&z_stream_);
+    }
+  }
+
+  // z_stream 的内部状态保存了指向 z_stream 自身的指针，用 inflateCopy 连同解压进度一起转移
+  Inflate(Inflate&& other)
+      : upstream_(std::move(other.upstream_)),
+        chunk_size_(other.chunk_size_),
+        output_(std::move(other.output_)),
+        end_of_stream_(other.end_of_stream_) {
+    z_stream_ = {};
+    CHECK_EQ(inflateCopy(&z_stream_, &other.z_stream_), Z_OK)
+        << "Failed to move zlib inflate stream";
+    inflateEnd(&other.z_stream_);
+  }
+
+  Inflate(const Inflate&) = delete;
+  Inflate& operator=(const Inflate&) = delete;
+
+  absl::StatusOr<bool> open_next() {
+    inflateReset(&z_stream_);
+    z_stream_.avail_in = 0;
+    end_of_stream_ = false;
+    return upstream_.open_next();
+  }
+
+  absl::StatusOr<std::span<const char>> read() {
+    z_stream_.next_out = reinterpret_cast<Bytef*>(output_.get());
+    z_stream_.avail_out = chunk_size_;
+    while (z_stream_.avail_out > 0 && !end_of_stream_) {
+      if (z_stream_.avail_in == 0) {
+        auto status_or_chunk = upstream_.read();
+        if (!status_or_chunk.ok()) {
+          return status_or_chunk.status();
+        }
+        if (status_or_chunk->empty()) {
+          end_of_stream_ = true;
+          break;
+        }
+        z_stream_.next_in =
+            const_cast<Bytef*>(reinterpret_cast<const Bytef*>(status_or_chunk->data()));
+        z_stream_.avail_in = status_or_chunk->size();
+      }
+
+      int ret = inflate(&z_stream_, Z_NO_FLUSH);
+      if (ret == Z_STREAM_END) {
+        // 同一文件中可能有多个 gzip member
+        inflateReset(&z_stream_);
+      } else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+        return absl::DataLossError(absl::StrFormat("Inflation failed: %d, msg: %s", ret,
+                                                   z_stream_.msg ? z_stream_.msg : ""));
+      }
+    }
+    return std::span<const char>(output_.get(), chunk_size_ - z_stream_.avail_out);
+  }
+
+ private:
+  Upstream upstream_;
+  size_t chunk_size_;
+  std::unique_ptr<char[]> output_;
+  z_stream z_stream_;
+  bool end_of_stream_ = false;
+};
+
+/**
+ * @brief LineSource splitting the streams of its upstream on '\n'. A line spanning two chunks is
+ * reassembled, and the last line of a stream needs no trailing newline.
+ */
+template <ByteSource Upstream>
+class LineSplit {
+ public:
+  explicit LineSplit(Upstream upstream) : upstream_(std::move(upstream)) {}
+
+  template <typename Sink>
+  absl::StatusOr<bool> read_lines(Sink&& sink) {
+    while (true) {
+      if (chunk_.empty()) {
+        if (!stream_open_) {
+          auto status_or_more = upstream_.open_next();
+          if (!status_or_more.ok()) {
+            return status_or_more.status();
+          }
+          if (!status_or_more.value()) {
+            return false;
+          }
+          stream_open_ = true;
+        }
+        auto status_or_chunk = upstream_.read();
+        if (!status_or_chunk.ok()) {
+          return status_or_chunk.status();
+        }
+        if (status_or_chunk->empty()) {
+          stream_open_ = false;
+          if (!pending_line_.empty()) {
+            bool go_on = sink(std::string_view(pending_line_));
+            pending_line_.clear();
+            if (!go_on) {
+              return true;
+            }
+          }
+          continue;
+        }
+        chunk_ = status_or_chunk.value();
+      }
+
+      const char* p = chunk_.data();
+      const char* end = p + chunk_.size();
+      while (true) {
+        const char* newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (newline == nullptr) {
+          // 不完整的行，留到下一个 chunk 拼接
+          pending_line_.append(p, end - p);
+          chunk_ = {};
+          break;
+        }
+        std::string_view line(p, newline - p);
+        p = newline + 1;
+        bool go_on;
+        if (!pending_line_.empty()) {
+          pending_line_.append(line);
+          go_on = sink(std::string_view(pending_line_));
+          pending_line_.clear();
+        } else {
+          go_on = sink(line);
+        }
+        if (!go_on) {
+          chunk_ = std::span<const char>(p, end - p);
+          return true;
+        }
+      }
+    }
+  }
+
+ private:
+  Upstream upstream_;
+  std::span<const char> chunk_;
+  std::string pending_line_;
+  bool stream_open_ = false;
+};
+
+/**
+ * @brief BatchSource parsing the lines of its upstream with TextLineParser into SampleBatch of at
+ * most batch_size rows. Batches span file boundaries; only the last batch may be smaller.
+ */
+template <LineSource Upstream>
+class Parse {
+ public:
+  Parse(Upstream upstream, size_t batch_size, const TextSampleOptions& options = {})
+      : upstream_(std::move(upstream)), batch_size_(batch_size), parser_(options) {}
+
+  absl::StatusOr<std::shared_ptr<SampleBatch>> next_batch() {
+    absl::Status status;
+    auto sink = [&](std::string_view line) {
+      if (line.empty()) {
+        return true;
+      }
+      auto status_or_kept = parser_.parse_line(line);
+      if (!status_or_kept.ok()) {
+        status = status_or_kept.status();
+        return false;
+      }
+      return parser_.rows() < batch_size_;
+    };
+
+    while (parser_.rows() < batch_size_) {
+      auto status_or_more = upstream_.read_lines(sink);
+      if (!status.ok()) {
+        return status;
+      }
+      if (!status_or_more.ok()) {
+        return status_or_more.status();
+      }
+      if (!status_or_more.value()) {
+        break;  // 输入结束
+      }
+    }
+
+    if (parser_.rows() == 0) {
+      return nullptr;
+    }
+    return parser_.finish_batch();
+  }
+
+  uint64_t rows_filtered() const { return parser_.rows_filtered(); }
+
+ private:
+  Upstream upstream_;
+  size_t batch_size_;
+  TextLineParser parser_;
+};
+
+}  // namespace data_flow
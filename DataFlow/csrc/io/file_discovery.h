@@ -0,0 +1,388 @@
+/**
+ * @file file_discovery.h
+ * @brief Definition of FileDiscovery, a lazy and parallel expansion of glob patterns.
+ *
+ * Author: Jasmine (1011694931@qq.com)
+ * Created on: 2025-11-12
+ *
+ * Copyright (c) 2025 Jasmine. All rights reserved.
+ */
+
+#pragma once
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <fnmatch.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "glog/logging.h"
+
+#include "DataFlow/csrc/common/threads.h"
+
+namespace data_flow {
+
+/**
+ * @brief A regular file found by FileDiscovery, with the size reported by the walk.
+ */
+struct FileEntry {
+  std::string path;
+  uint64_t size = 0;
+};
+
+/**
+ * @brief Options of file discovery in DataReader.
+ */
+struct FileDiscoveryOptions {
+  // threads walking directories
+  size_t num_threads = 8;
+  // if positive, files are read largest first among the next `lookahead` discovered files, so
+  // that long files do not end up at the tail of the input
+  size_t lookahead = 0;
+  // skip zero-length files
+  bool skip_empty = true;
+};
+
+/**
+ * @brief FileDiscovery expands glob patterns and directory prefixes into regular files with a
+ * pool of threads walking directories in parallel. Files are handed out by next() as soon as they
+ * are found, so reading can start long before the enumeration is finished.
+ *
+ * Inputs:
+ * - a pattern such as "/data/day=2025111[0-9]/part-*.gz": components are matched with fnmatch(3),
+ *   and a "**" component matches any number of directories;
+ * - a directory, or a path ending with '/': every regular file below it;
+ * - a plain file path: the file itself.
+ *
+ * "**" and directories skip names starting with '.' or '_' (".part-00000.crc", "_SUCCESS").
+ *
+ * Symbolic links are followed. Below a "**" every directory is scanned at most once per pattern,
+ * so a link to an ancestor directory does not make the walk recurse forever.
+ *
+ * The order of the files is not deterministic.
+ */
+class FileDiscovery {
+ public:
+  FileDiscovery(const std::vector<std::string>& patterns, size_t num_threads) {
+    for (const auto& pattern : patterns) {
+      add_pattern(pattern);
+    }
+    num_threads = std::max<size_t>(num_threads, 1);
+    for (size_t i = 0; i < num_threads; ++i) {
+      workers_.push_back(Threads::Start([this] { work(); }));
+    }
+  }
+
+  ~FileDiscovery() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopped_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  FileDiscovery(const FileDiscovery&) = delete;
+  FileDiscovery& operator=(const FileDiscovery&) = delete;
+
+  /**
+   * @brief Next discovered file, waiting for the walk if none is available yet.
+   * @return The file, std::nullopt once every pattern is fully expanded, or the first error met by
+   * the walk (a missing literal path or an unreadable directory).
+   */
+  absl::StatusOr<std::optional<FileEntry>> next() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    consumer_waiting_ = true;
+    output_cv_.wait(lock, [this] { return !output_.empty() || pending_dirs_ == 0; });
+    consumer_waiting_ = false;
+    if (output_.empty()) {
+      if (!status_.ok()) {
+        return status_;
+      }
+      return std::nullopt;
+    }
+    FileEntry entry = std::move(output_.front());
+    output_.pop_front();
+    return entry;
+  }
+
+  /**
+   * @brief Number of files and bytes found so far.
+   */
+  uint64_t discovered_files() const { return discovered_files_.load(std::memory_order_relaxed); }
+  uint64_t discovered_bytes() const { return discovered_bytes_.load(std::memory_order_relaxed); }
+
+ private:
+  /**
+   * @brief A directory to scan. rel holds the path components below the pattern root.
+   */
+  struct DirTask {
+    std::string path;
+    std::vector<std::string> rel;
+    size_t pattern;
+  };
+
+  /**
+   * @brief Pattern split into its literal root directory and the components to match below it.
+   */
+  struct Pattern {
+    std::string root;
+    std::vector<std::string> components;
+    // 含 "**" 时目录深度不受限，记录已扫描目录的 (st_dev, st_ino)，受 mutex_ 保护
+    bool recursive = false;
+    std::set<std::pair<dev_t, ino_t>> visited;
+  };
+
+  static bool has_wildcard(std::string_view s) { return s.find_first_of("*?[") != s.npos; }
+
+  static std::vector<std::string> split(const std::string& path) {
+    std::vector<std::string> parts;
+    size_t begin = 0;
+    while (begin <= path.size()) {
+      size_t end = path.find('/', begin);
+      if (end == std::string::npos) end = path.size();
+      if (end > begin) parts.push_back(path.substr(begin, end - begin));
+      begin = end + 1;
+    }
+    return parts;
+  }
+
+  /**
+   * @brief Hidden files (".part-00000.crc") and job markers ("_SUCCESS", "_temporary") are not
+   * data; "**" and directory inputs skip them, an explicit pattern such as "_*" still matches.
+   */
+  static bool is_hidden(std::string_view name) {
+    return !name.empty() && (name[0] == '.' || name[0] == '_');
+  }
+
+  /**
+   * @brief Match path components against pattern components.
+   * @param prefix If true, path is a directory and only needs to be a prefix of a possible match.
+   */
+  static bool match(const std::vector<std::string>& pattern, size_t i,
+                    const std::vector<std::string>& path, size_t j, bool prefix) {
+    if (j == path.size()) {
+      return prefix ? i < pattern.size()
+                    : i == pattern.size() || (i + 1 == pattern.size() && pattern[i] == "**");
+    }
+    if (i == pattern.size()) {
+      return false;
+    }
+    if (pattern[i] == "**") {
+      // "**" 匹配零个或多个目录，不匹配隐藏文件与目录
+      return match(pattern, i + 1, path, j, prefix) ||
+             (!is_hidden(path[j]) && match(pattern, i, path, j + 1, prefix));
+    }
+    return fnmatch(pattern[i].c_str(), path[j].c_str(), FNM_PERIOD) == 0 &&
+           match(pattern, i + 1, path, j + 1, prefix);
+  }
+
+  void add_pattern(const std::string& input) {
+    if (input.empty()) {
+      return;
+    }
+    struct stat st;
+    const bool is_dir = !has_wildcard(input) && ::stat(input.c_str(), &st) == 0 &&
+                        S_ISDIR(st.st_mode);
+    if (!has_wildcard(input) && !is_dir && input.back() != '/') {
+      // 普通文件直接输出
+      if (::stat(input.c_str(), &st) != 0) {
+        set_error(absl::NotFoundError(absl::StrFormat("File not found: %s", input)));
+      } else {
+        push_output({FileEntry{input, static_cast<uint64_t>(st.st_size)}});
+      }
+      return;
+    }
+
+    Pattern pattern;
+    auto components = split(input);
+    size_t literal = 0;
+    while (literal < components.size() && !has_wildcard(components[literal])) {
+      ++literal;
+    }
+    if (is_dir || input.back() == '/') {
+      literal = components.size();
+    }
+    pattern.root = input.front() == '/' ? "/" : "";
+    for (size_t i = 0; i < literal; ++i) {
+      pattern.root += components[i] + "/";
+    }
+    if (pattern.root.empty()) {
+      pattern.root = "./";
+    }
+    pattern.components.assign(components.begin() + literal, components.end());
+    if (pattern.components.empty()) {
+      pattern.components.push_back("**");
+    }
+    pattern.recursive = std::find(pattern.components.begin(), pattern.components.end(), "**") !=
+                        pattern.components.end();
+
+    patterns_.push_back(std::move(pattern));
+    ++pending_dirs_;
+    work_.push_back(DirTask{patterns_.back().root, {}, patterns_.size() - 1});
+  }
+
+  void set_error(absl::Status status) {
+    LOG(WARNING) << "[FileDiscovery] " << status;
+    if (status_.ok()) {
+      status_ = std::move(status);
+    }
+  }
+
+  void push_output(std::vector<FileEntry>&& entries) {
+    for (auto& entry : entries) {
+      discovered_bytes_.fetch_add(entry.size, std::memory_order_relaxed);
+      output_.push_back(std::move(entry));
+    }
+    discovered_files_.fetch_add(entries.size(), std::memory_order_relaxed);
+    output_cv_.notify_one();
+  }
+
+  void work() {
+    while (true) {
+      DirTask task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        work_cv_.wait(lock, [this] { return stopped_ || !work_.empty(); });
+        if (stopped_) {
+          return;
+        }
+        task = std::move(work_.front());
+        work_.pop_front();
+      }
+      scan(task);
+    }
+  }
+
+  /**
+   * @brief Record the directory open at dir_fd as scanned for the pattern.
+   * @return false if the pattern already scanned it. Patterns without "**" have a bounded depth
+   * and are not tracked.
+   */
+  bool first_visit(size_t pattern, int dir_fd) {
+    struct stat st;
+    if (!patterns_[pattern].recursive || ::fstat(dir_fd, &st) != 0) {
+      return true;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    return patterns_[pattern].visited.emplace(st.st_dev, st.st_ino).second;
+  }
+
+  /**
+   * @brief List one directory: matching files go to the output, matching subdirectories to the
+   * work queue. Sizes come from fstatat on the open directory, without resolving full paths.
+   */
+  void scan(const DirTask& task) {
+    static constexpr size_t kFlushEntries = 64;
+    const Pattern& pattern = patterns_[task.pattern];
+    std::vector<FileEntry> files;
+    std::vector<DirTask> dirs;
+    bool flushed = false;
+
+    auto flush = [&](bool force) {
+      if (files.empty() && dirs.empty()) return;
+      // 消费者在等待时立即交付第一个文件，之后按批交付，避免每个文件都唤醒消费者
+      const bool eager = !flushed && consumer_waiting_.load(std::memory_order_relaxed);
+      if (!force && files.size() < kFlushEntries && dirs.empty() && !eager) {
+        return;
+      }
+      flushed = true;
+      std::lock_guard<std::mutex> lock(mutex_);
+      pending_dirs_ += dirs.size();
+      for (auto& dir : dirs) {
+        work_.push_back(std::move(dir));
+      }
+      if (!dirs.empty()) {
+        work_cv_.notify_all();
+      }
+      if (!files.empty()) {
+        push_output(std::move(files));
+      }
+      files.clear();
+      dirs.clear();
+    };
+
+    int dir_fd = ::open(task.path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    DIR* dir = dir_fd < 0 ? nullptr : ::fdopendir(dir_fd);
+    if (dir == nullptr) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      set_error(absl::NotFoundError(
+          absl::StrFormat("Failed to open directory %s: %s", task.path, std::strerror(errno))));
+      if (dir_fd >= 0) ::close(dir_fd);
+    } else if (!first_visit(task.pattern, dir_fd)) {
+      // 经符号链接再次到达已扫描的目录(例如指向祖先目录的链接)，跳过以免无限递归
+      VLOG(3) << "[FileDiscovery] skip directory visited before: " << task.path;
+      ::closedir(dir);
+    } else {
+      std::vector<std::string> rel = task.rel;
+      while (dirent* entry = ::readdir(dir)) {
+        std::string_view name = entry->d_name;
+        if (name == "." || name == "..") continue;
+
+        bool is_dir = entry->d_type == DT_DIR;
+        bool is_file = entry->d_type == DT_REG;
+        struct stat st;
+        if (is_file || entry->d_type == DT_UNKNOWN || entry->d_type == DT_LNK) {
+          if (::fstatat(dir_fd, entry->d_name, &st, 0) != 0) continue;
+          is_dir = S_ISDIR(st.st_mode);
+          is_file = S_ISREG(st.st_mode);
+        }
+
+        rel.emplace_back(name);
+        if (is_file && match(pattern.components, 0, rel, 0, false)) {
+          files.push_back(FileEntry{task.path + std::string(name),
+                                    static_cast<uint64_t>(st.st_size)});
+        } else if (is_dir && match(pattern.components, 0, rel, 0, true)) {
+          dirs.push_back(DirTask{task.path + std::string(name) + "/", rel, task.pattern});
+        }
+        rel.pop_back();
+        flush(false);
+      }
+      ::closedir(dir);
+    }
+
+    flush(true);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (--pending_dirs_ == 0) {
+      output_cv_.notify_all();
+    }
+  }
+
+  std::vector<Pattern> patterns_;
+
+  std::mutex mutex_;
+  std::condition_variable work_cv_;
+  std::condition_variable output_cv_;
+  std::deque<DirTask> work_;
+  std::deque<FileEntry> output_;
+  size_t pending_dirs_ = 0;
+  bool stopped_ = false;
+  std::atomic<bool> consumer_waiting_ = false;
+  absl::Status status_;
+
+  std::atomic<uint64_t> discovered_files_ = 0;
+  std::atomic<uint64_t> discovered_bytes_ = 0;
+
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace data_flow
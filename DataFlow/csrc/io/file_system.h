@@ -0,0 +1,116 @@
+/**
+ * @file file_system.h
+ * @brief Definition of the RandomAccessFile and FileSystem interfaces and the local file system.
+ *
+ * Author: Jasmine (1011694931@qq.com)
+ * Created on: 2025-11-17
+ *
+ * Copyright (c) 2025 Jasmine. All rights reserved.
+ */
+
+#pragma once
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+
+namespace data_flow {
+
+/**
+ * @brief RandomAccessFile reads byte ranges of a file of known size. read() may be called from
+ * several threads at once, which is how ReadaheadReader keeps many ranges in flight.
+ */
+class RandomAccessFile {
+ public:
+  virtual ~RandomAccessFile() = default;
+
+  virtual const std::string& uri() const = 0;
+  virtual uint64_t size() const = 0;
+
+  /**
+   * @brief Read up to n bytes at offset into dst.
+   * @return Number of bytes read, less than n only at the end of the file.
+   */
+  virtual absl::StatusOr<size_t> read(uint64_t offset, size_t n, char* dst) = 0;
+};
+
+/**
+ * @brief FileSystem opens the files of one or more uri schemes.
+ */
+class FileSystem {
+ public:
+  virtual ~FileSystem() = default;
+
+  virtual absl::StatusOr<std::unique_ptr<RandomAccessFile>> open(const std::string& uri) = 0;
+};
+
+/**
+ * @brief Local file read with pread(2); uris are paths, optionally prefixed with "file://".
+ */
+class LocalRandomAccessFile final : public RandomAccessFile {
+ public:
+  LocalRandomAccessFile(std::string uri, int fd, uint64_t size)
+      : uri_(std::move(uri)), fd_(fd), size_(size) {}
+
+  ~LocalRandomAccessFile() final { ::close(fd_); }
+
+  const std::string& uri() const final { return uri_; }
+  uint64_t size() const final { return size_; }
+
+  absl::StatusOr<size_t> read(uint64_t offset, size_t n, char* dst) final {
+    size_t done = 0;
+    while (done < n) {
+      ssize_t r = ::pread(fd_, dst + done, n - done, offset + done);
+      if (r < 0 && errno == EINTR) {
+        continue;
+      }
+      if (r < 0) {
+        return absl::InternalError(
+            absl::StrFormat("Failed to read %s: %s", uri_, std::strerror(errno)));
+      }
+      if (r == 0) {
+        break;
+      }
+      done += r;
+    }
+    return done;
+  }
+
+ private:
+  std::string uri_;
+  int fd_;
+  uint64_t size_;
+};
+
+class LocalFileSystem final : public FileSystem {
+ public:
+  absl::StatusOr<std::unique_ptr<RandomAccessFile>> open(const std::string& uri) final {
+    std::string_view path = uri;
+    if (path.starts_with("file://")) {
+      path.remove_prefix(std::strlen("file://"));
+    }
+    int fd = ::open(std::string(path).c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      return absl::NotFoundError(
+          absl::StrFormat("Failed to open file: %s: %s", uri, std::strerror(errno)));
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+      ::close(fd);
+      return absl::InternalError(absl::StrFormat("Failed to stat %s", uri));
+    }
+    return std::make_unique<LocalRandomAccessFile>(uri, fd, st.st_size);
+  }
+};
+
+}  // namespace data_flow
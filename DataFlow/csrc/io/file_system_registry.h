@@ -0,0 +1,110 @@
+/**
+ * @file file_system_registry.h
+ * @brief Definition of FileSystemRegistry, choosing the file system of a uri by its scheme.
+ *
+ * Author: Jasmine (1011694931@qq.com)
+ * Created on: 2025-11-17
+ *
+ * Copyright (c) 2025 Jasmine. All rights reserved.
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+
+#include "DataFlow/csrc/io/file_system.h"
+#include "DataFlow/csrc/io/http_file_system.h"
+#include "DataFlow/csrc/io/webhdfs_file_system.h"
+
+namespace data_flow {
+
+/**
+ * @brief FileSystemRegistry maps uri schemes ("http", "hdfs", ...) to file systems. Uris without
+ * a registered scheme are local paths. The registry starts with "http" (HttpFileSystem)
+ * and "webhdfs"/"hdfs" (WebHdfsFileSystem); more can be added with register_file_system().
+ */
+class FileSystemRegistry {
+ public:
+  using Factory = std::function<std::shared_ptr<FileSystem>()>;
+
+  static FileSystemRegistry& Instance() {
+    static FileSystemRegistry registry;
+    return registry;
+  }
+
+  /**
+   * @brief Register a file system for a scheme, replacing any previous one. The factory is called
+   * once, on the first open of a uri of the scheme.
+   */
+  void register_file_system(const std::string& scheme, Factory factory) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_[scheme] = Entry{std::move(factory), nullptr};
+  }
+
+  /**
+   * @brief Whether uri has a registered scheme other than "file".
+   */
+  bool is_remote(const std::string& uri) {
+    std::string scheme = Scheme(uri);
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !scheme.empty() && scheme != "file" && entries_.contains(scheme);
+  }
+
+  absl::StatusOr<std::shared_ptr<FileSystem>> get(const std::string& uri) {
+    std::string scheme = Scheme(uri);
+    if (scheme.empty() || scheme == "file") {
+      return local_;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(scheme);
+    if (it == entries_.end()) {
+      return absl::UnimplementedError(absl::StrFormat("No file system for scheme %s", scheme));
+    }
+    if (it->second.file_system == nullptr) {
+      it->second.file_system = it->second.factory();
+    }
+    return it->second.file_system;
+  }
+
+  absl::StatusOr<std::unique_ptr<RandomAccessFile>> open(const std::string& uri) {
+    auto status_or_fs = get(uri);
+    if (!status_or_fs.ok()) {
+      return status_or_fs.status();
+    }
+    return status_or_fs.value()->open(uri);
+  }
+
+  static std::string Scheme(const std::string& uri) {
+    size_t pos = uri.find("://");
+    return pos == std::string::npos ? std::string() : uri.substr(0, pos);
+  }
+
+ private:
+  struct Entry {
+    Factory factory;
+    std::shared_ptr<FileSystem> file_system;
+  };
+
+  FileSystemRegistry() {
+    Factory http = [] { return std::make_shared<HttpFileSystem>(); };
+    Factory webhdfs = [] { return std::make_shared<WebHdfsFileSystem>(); };
+    entries_["http"].factory = http;
+    // 不支持 TLS，https 在 open 时返回 Unimplemented 而不是被当作本地路径
+    entries_["https"].factory = http;
+    entries_["webhdfs"].factory = webhdfs;
+    entries_["hdfs"].factory = webhdfs;
+  }
+
+  std::mutex mutex_;
+  absl::flat_hash_map<std::string, Entry> entries_;
+  std::shared_ptr<FileSystem> local_ = std::make_shared<LocalFileSystem>();
+};
+
+}  // namespace data_flow
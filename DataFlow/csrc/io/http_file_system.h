@@ -0,0 +1,665 @@
+/**
+ * @file http_file_system.h
+ * @brief Definition of a minimal HTTP/1.1 client and HttpFileSystem, reading files of an HTTP
+ * server with range requests.
+ *
+ * Author: Jasmine (1011694931@qq.com)
+ * Created on: 2025-11-17
+ *
+ * Copyright (c) 2025 Jasmine. All rights reserved.
+ */
+
+#pragma once
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "glog/logging.h"
+
+#include "DataFlow/csrc/io/file_system.h"
+
+namespace data_flow {
+
+/**
+ * @brief Options of HttpClient.
+ */
+struct HttpOptions {
+  // connect, send and receive timeout of every request
+  int64_t timeout_ms = 30000;
+  int max_redirects = 5;
+  // requested socket receive buffer, large enough for a high bandwidth-delay product
+  int receive_buffer = 4 << 20;
+};
+
+/**
+ * @brief Parsed "scheme://host[:port]/target" url.
+ */
+struct HttpUrl {
+  std::string scheme;
+  std::string host;
+  uint16_t port = 80;
+  std::string target = "/";
+
+  static absl::StatusOr<HttpUrl> Parse(std::string_view url, uint16_t default_port = 80) {
+    HttpUrl parsed;
+    size_t pos = url.find("://");
+    if (pos == std::string_view::npos) {
+      return absl::InvalidArgumentError(absl::StrFormat("Bad url: %s", url));
+    }
+    parsed.scheme = std::string(url.substr(0, pos));
+    std::string_view rest = url.substr(pos + 3);
+    size_t slash = rest.find('/');
+    std::string_view authority = rest.substr(0, slash);
+    if (slash != std::string_view::npos) {
+      parsed.target = std::string(rest.substr(slash));
+    }
+    parsed.port = default_port;
+    size_t colon = authority.rfind(':');
+    if (colon != std::string_view::npos) {
+      auto result = std::from_chars(authority.data() + colon + 1,
+                                    authority.data() + authority.size(), parsed.port);
+      if (result.ec != std::errc() || result.ptr != authority.data() + authority.size()) {
+        return absl::InvalidArgumentError(absl::StrFormat("Bad port in url: %s", url));
+      }
+      authority = authority.substr(0, colon);
+    }
+    if (authority.empty()) {
+      return absl::InvalidArgumentError(absl::StrFormat("Missing host in url: %s", url));
+    }
+    parsed.host = std::string(authority);
+    return parsed;
+  }
+
+  std::string authority() const { return absl::StrFormat("%s:%d", host, port); }
+};
+
+/**
+ * @brief Status line, headers and, unless it was read into the caller's buffer, body of a
+ * response. Header names are lower case.
+ */
+struct HttpResponse {
+  int status = 0;
+  absl::flat_hash_map<std::string, std::string> headers;
+  std::string body;
+  // 读入调用方缓冲区的 body 字节数
+  size_t body_size = 0;
+  // 成功响应的 body 超出调用方缓冲区：未读入缓冲区，以 Content-Length 给出长度时也不读取
+  bool oversized = false;
+
+  const std::string* header(const std::string& name) const {
+    auto it = headers.find(name);
+    return it == headers.end() ? nullptr : &it->second;
+  }
+};
+
+/**
+ * @brief HttpConnection is one keep-alive TCP connection issuing GET requests.
+ */
+class HttpConnection {
+ public:
+  static absl::StatusOr<std::unique_ptr<HttpConnection>> Connect(const std::string& host,
+                                                                 uint16_t port,
+                                                                 const HttpOptions& options) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    int rc = ::getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses);
+    if (rc != 0) {
+      return absl::UnavailableError(
+          absl::StrFormat("Failed to resolve %s: %s", host, ::gai_strerror(rc)));
+    }
+
+    int fd = -1;
+    int error = 0;
+    for (addrinfo* ai = addresses; ai != nullptr && fd < 0; ai = ai->ai_next) {
+      fd = ::socket(ai->ai_family, ai->ai_socktype | SOCK_CLOEXEC, ai->ai_protocol);
+      if (fd < 0) {
+        error = errno;
+        continue;
+      }
+      SetTimeouts(fd, options.timeout_ms);
+      if (::connect(fd, ai->ai_addr, ai->ai_addrlen) != 0) {
+        error = errno;
+        ::close(fd);
+        fd = -1;
+      }
+    }
+    ::freeaddrinfo(addresses);
+    if (fd < 0) {
+      return absl::UnavailableError(
+          absl::StrFormat("Failed to connect to %s:%d: %s", host, port, std::strerror(error)));
+    }
+    int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &options.receive_buffer,
+                 sizeof(options.receive_buffer));
+    return std::unique_ptr<HttpConnection>(new HttpConnection(fd, host, port));
+  }
+
+  ~HttpConnection() { ::close(fd_); }
+
+  HttpConnection(const HttpConnection&) = delete;
+  HttpConnection& operator=(const HttpConnection&) = delete;
+
+  const std::string& host() const { return host_; }
+  uint16_t port() const { return port_; }
+
+  /**
+   * @brief Whether the connection can carry another request.
+   */
+  bool reusable() const { return reusable_; }
+
+  /**
+   * @brief Whether the status line and headers of the last request were received.
+   */
+  bool response_started() const { return response_started_; }
+
+  /**
+   * @brief Send a GET request and read the response. A successful (2xx) body of at most capacity
+   * bytes is read straight into dst; any other body is read into response.body. A successful body
+   * larger than capacity sets response.oversized, so that the caller can still look at the status
+   * (e.g. a server ignoring Range replies 200 with the whole file); its download stops once it
+   * exceeds capacity (at once when its Content-Length is known), and the connection is then closed.
+   */
+  absl::StatusOr<HttpResponse> get(const std::string& target, const std::string& extra_headers,
+                                   char* dst, size_t capacity) {
+    reusable_ = false;
+    response_started_ = false;
+    std::string request = absl::StrFormat(
+        "GET %s HTTP/1.1\r\nHost: %s:%d\r\nUser-Agent: DataFlow\r\nAccept-Encoding: identity\r\n"
+        "%s\r\n",
+        target, host_, port_, extra_headers);
+    auto status = send_all(request);
+    if (!status.ok()) {
+      return status;
+    }
+
+    HttpResponse response;
+    status = read_head(&response);
+    if (!status.ok()) {
+      return status;
+    }
+    response_started_ = true;
+
+    const bool to_dst = dst != nullptr && response.status >= 200 && response.status < 300;
+    // 分块或以关闭连接结束的 body 超过 limit 后停止读取
+    const size_t limit = to_dst ? capacity : std::numeric_limits<size_t>::max();
+    bool keep_alive = true;
+    if (const auto* connection = response.header("connection")) {
+      keep_alive = LowerCase(*connection) != "close";
+    }
+
+    if (const auto* encoding = response.header("transfer-encoding");
+        encoding != nullptr && LowerCase(*encoding) == "chunked") {
+      status = read_chunked(&response.body, limit, &response.oversized);
+      if (status.ok() && to_dst) {
+        if (response.oversized) {
+          // 连接上剩余的 chunk 随连接一起丢弃
+          keep_alive = false;
+        } else {
+          std::memcpy(dst, response.body.data(), response.body.size());
+          response.body_size = response.body.size();
+          response.body.clear();
+        }
+      }
+    } else if (const auto* length = response.header("content-length")) {
+      size_t size = 0;
+      auto result = std::from_chars(length->data(), length->data() + length->size(), size);
+      if (result.ec != std::errc()) {
+        return absl::InternalError(absl::StrFormat("Bad Content-Length: %s", *length));
+      }
+      if (to_dst && size > capacity) {
+        // 不下载多余的 body，连接上剩余的数据随连接一起丢弃
+        response.oversized = true;
+        keep_alive = false;
+      } else if (to_dst) {
+        status = read_exact(dst, size);
+        response.body_size = size;
+      } else {
+        response.body.resize(size);
+        status = read_exact(response.body.data(), size);
+      }
+    } else {
+      // 无长度信息：读到连接关闭为止
+      keep_alive = false;
+      status = read_until_close(&response.body, limit, &response.oversized);
+      if (status.ok() && to_dst) {
+        if (response.oversized) {
+          response.body.clear();
+        } else {
+          std::memcpy(dst, response.body.data(), response.body.size());
+          response.body_size = response.body.size();
+          response.body.clear();
+        }
+      }
+    }
+    if (!status.ok()) {
+      return status;
+    }
+    reusable_ = keep_alive;
+    return response;
+  }
+
+ private:
+  static constexpr size_t kMaxHeaderBytes = 64 * 1024;
+
+  HttpConnection(int fd, std::string host, uint16_t port)
+      : fd_(fd), host_(std::move(host)), port_(port) {}
+
+  static void SetTimeouts(int fd, int64_t timeout_ms) {
+    timeval tv{};
+    tv.tv_sec = timeout_ms / 1000;
+    tv.tv_usec = (timeout_ms % 1000) * 1000;
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+  }
+
+  static std::string LowerCase(std::string_view s) {
+    std::string lower(s);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+    return lower;
+  }
+
+  static std::string_view Trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) {
+      s.remove_suffix(1);
+    }
+    return s;
+  }
+
+  absl::Status io_error(const char* what) const {
+    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+      return absl::DeadlineExceededError(
+          absl::StrFormat("Timed out %s %s:%d", what, host_, port_));
+    }
+    return absl::UnavailableError(
+        absl::StrFormat("Failed %s %s:%d: %s", what, host_, port_, std::strerror(errno)));
+  }
+
+  absl::Status send_all(std::string_view data) {
+    while (!data.empty()) {
+      ssize_t n = ::send(fd_, data.data(), data.size(), MSG_NOSIGNAL);
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      if (n < 0) {
+        return io_error("sending to");
+      }
+      data.remove_prefix(n);
+    }
+    return absl::OkStatus();
+  }
+
+  /**
+   * @brief Receive into the internal buffer.
+   * @return false at end of stream.
+   */
+  absl::StatusOr<bool> fill() {
+    if (begin_ > 0 && begin_ == buffer_.size()) {
+      buffer_.clear();
+      begin_ = 0;
+    }
+    char chunk[16 * 1024];
+    while (true) {
+      ssize_t n = ::recv(fd_, chunk, sizeof(chunk), 0);
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      if (n < 0) {
+        return io_error("receiving from");
+      }
+      buffer_.append(chunk, n);
+      return n > 0;
+    }
+  }
+
+  absl::StatusOr<std::string> read_line() {
+    while (true) {
+      size_t eol = buffer_.find("\r\n", begin_);
+      if (eol != std::string::npos) {
+        std::string line = buffer_.substr(begin_, eol - begin_);
+        begin_ = eol + 2;
+        return line;
+      }
+      if (buffer_.size() - begin_ > kMaxHeaderBytes) {
+        return absl::InternalError("HTTP header line too long");
+      }
+      auto status_or_more = fill();
+      if (!status_or_more.ok()) {
+        return status_or_more.status();
+      }
+      if (!status_or_more.value()) {
+        return absl::UnavailableError(
+            absl::StrFormat("Connection to %s:%d closed", host_, port_));
+      }
+    }
+  }
+
+  absl::Status read_head(HttpResponse* response) {
+    auto status_or_line = read_line();
+    if (!status_or_line.ok()) {
+      return status_or_line.status();
+    }
+    // HTTP/1.1 206 Partial Content
+    std::string_view status_line = status_or_line.value();
+    size_t space = status_line.find(' ');
+    if (!status_line.starts_with("HTTP/") || space == std::string_view::npos ||
+        std::from_chars(status_line.data() + space + 1, status_line.data() + status_line.size(),
+                        response->status)
+                .ec != std::errc()) {
+      return absl::InternalError(absl::StrFormat("Bad HTTP status line: %s", status_line));
+    }
+    const bool http10 = status_line.starts_with("HTTP/1.0");
+    while (true) {
+      status_or_line = read_line();
+      if (!status_or_line.ok()) {
+        return status_or_line.status();
+      }
+      std::string_view line = status_or_line.value();
+      if (line.empty()) {
+        break;
+      }
+      size_t colon = line.find(':');
+      if (colon != std::string_view::npos) {
+        response->headers[LowerCase(Trim(line.substr(0, colon)))] =
+            std::string(Trim(line.substr(colon + 1)));
+      }
+    }
+    if (http10 && !response->headers.contains("connection")) {
+      response->headers["connection"] = "close";
+    }
+    return absl::OkStatus();
+  }
+
+  /**
+   * @brief Read n body bytes: first those already buffered, then straight from the socket.
+   */
+  absl::Status read_exact(char* dst, size_t n) {
+    const size_t buffered = std::min(n, buffer_.size() - begin_);
+    std::memcpy(dst, buffer_.data() + begin_, buffered);
+    begin_ += buffered;
+    size_t done = buffered;
+    while (done < n) {
+      ssize_t r = ::recv(fd_, dst + done, n - done, 0);
+      if (r < 0 && errno == EINTR) {
+        continue;
+      }
+      if (r < 0) {
+        return io_error("receiving from");
+      }
+      if (r == 0) {
+        return absl::UnavailableError(absl::StrFormat(
+            "Connection to %s:%d closed after %d of %d body bytes", host_, port_, done, n));
+      }
+      done += r;
+    }
+    return absl::OkStatus();
+  }
+
+  /**
+   * @brief Read a chunked body into body, stopping with *oversized set once it exceeds limit.
+   */
+  absl::Status read_chunked(std::string* body, size_t limit, bool* oversized) {
+    while (true) {
+      auto status_or_line = read_line();
+      if (!status_or_line.ok()) {
+        return status_or_line.status();
+      }
+      const std::string& line = status_or_line.value();
+      size_t size = 0;
+      if (std::from_chars(line.data(), line.data() + line.size(), size, 16).ec != std::errc()) {
+        return absl::InternalError(absl::StrFormat("Bad chunk size: %s", line));
+      }
+      if (size == 0) {
+        // 跳过 trailer
+        do {
+          status_or_line = read_line();
+          if (!status_or_line.ok()) {
+            return status_or_line.status();
+          }
+        } while (!status_or_line->empty());
+        return absl::OkStatus();
+      }
+      const size_t offset = body->size();
+      if (size > limit - offset) {
+        *oversized = true;
+        body->clear();
+        return absl::OkStatus();
+      }
+      body->resize(offset + size);
+      auto status = read_exact(body->data() + offset, size);
+      if (status.ok()) {
+        status = read_line().status();  // chunk 结尾的 CRLF
+      }
+      if (!status.ok()) {
+        return status;
+      }
+    }
+  }
+
+  /**
+   * @brief Read a body ending with the connection into body, stopping with *oversized set once it
+   * exceeds limit.
+   */
+  absl::Status read_until_close(std::string* body, size_t limit, bool* oversized) {
+    while (true) {
+      if (buffer_.size() - begin_ > limit) {
+        *oversized = true;
+        begin_ = buffer_.size();
+        return absl::OkStatus();
+      }
+      auto status_or_more = fill();
+      if (!status_or_more.ok()) {
+        return status_or_more.status();
+      }
+      if (!status_or_more.value()) {
+        body->append(buffer_, begin_);
+        begin_ = buffer_.size();
+        return absl::OkStatus();
+      }
+    }
+  }
+
+  int fd_;
+  std::string host_;
+  uint16_t port_;
+  bool reusable_ = false;
+  bool response_started_ = false;
+  std::string buffer_;
+  size_t begin_ = 0;
+};
+
+/**
+ * @brief HttpClient issues GET requests over pooled keep-alive connections, one request per
+ * connection at a time, so concurrent callers use separate connections. Redirects are followed.
+ */
+class HttpClient {
+ public:
+  explicit HttpClient(const HttpOptions& options = {}) : options_(options) {}
+
+  /**
+   * @brief GET url, see HttpConnection::get.
+   */
+  absl::StatusOr<HttpResponse> get(const std::string& url, const std::string& extra_headers = "",
+                                   char* dst = nullptr, size_t capacity = 0) {
+    std::string current = url;
+    for (int redirects = 0;; ++redirects) {
+      auto status_or_url = HttpUrl::Parse(current);
+      if (!status_or_url.ok()) {
+        return status_or_url.status();
+      }
+      if (status_or_url->scheme != "http") {
+        return absl::UnimplementedError(
+            absl::StrFormat("Unsupported url scheme %s: %s", status_or_url->scheme, current));
+      }
+      auto status_or_response = get_once(*status_or_url, extra_headers, dst, capacity);
+      if (!status_or_response.ok()) {
+        return status_or_response.status();
+      }
+      const int status = status_or_response->status;
+      const std::string* location = status_or_response->header("location");
+      if (status < 300 || status >= 400 || status == 304 || location == nullptr) {
+        return status_or_response;
+      }
+      if (redirects == options_.max_redirects) {
+        return absl::InternalError(absl::StrFormat("Too many redirects for %s", url));
+      }
+      current = location->starts_with("/")
+                    ? absl::StrFormat("http://%s%s", status_or_url->authority(), *location)
+                    : *location;
+      VLOG(6) << "[HttpClient] redirect to " << current;
+    }
+  }
+
+  const HttpOptions& options() const { return options_; }
+
+ private:
+  absl::StatusOr<HttpResponse> get_once(const HttpUrl& url, const std::string& extra_headers,
+                                        char* dst, size_t capacity) {
+    while (true) {
+      std::unique_ptr<HttpConnection> connection = take_idle(url.authority());
+      const bool pooled = connection != nullptr;
+      if (!pooled) {
+        auto status_or_connection = HttpConnection::Connect(url.host, url.port, options_);
+        if (!status_or_connection.ok()) {
+          return status_or_connection.status();
+        }
+        connection = std::move(status_or_connection).value();
+      }
+      auto status_or_response = connection->get(url.target, extra_headers, dst, capacity);
+      // 空闲连接可能已被服务端关闭，未收到响应时换新连接重试
+      if (!status_or_response.ok() && pooled && !connection->response_started()) {
+        continue;
+      }
+      if (status_or_response.ok() && connection->reusable()) {
+        put_idle(url.authority(), std::move(connection));
+      }
+      return status_or_response;
+    }
+  }
+
+  std::unique_ptr<HttpConnection> take_idle(const std::string& authority) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& idle = idle_[authority];
+    if (idle.empty()) {
+      return nullptr;
+    }
+    auto connection = std::move(idle.back());
+    idle.pop_back();
+    return connection;
+  }
+
+  void put_idle(const std::string& authority, std::unique_ptr<HttpConnection> connection) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    idle_[authority].push_back(std::move(connection));
+  }
+
+  HttpOptions options_;
+  std::mutex mutex_;
+  absl::flat_hash_map<std::string, std::vector<std::unique_ptr<HttpConnection>>> idle_;
+};
+
+/**
+ * @brief File of an HTTP server supporting range requests (206 Partial Content).
+ */
+class HttpRandomAccessFile final : public RandomAccessFile {
+ public:
+  HttpRandomAccessFile(std::string uri, uint64_t size, std::shared_ptr<HttpClient> client)
+      : uri_(std::move(uri)), size_(size), client_(std::move(client)) {}
+
+  const std::string& uri() const final { return uri_; }
+  uint64_t size() const final { return size_; }
+
+  absl::StatusOr<size_t> read(uint64_t offset, size_t n, char* dst) final {
+    if (offset >= size_ || n == 0) {
+      return 0;
+    }
+    n = std::min<uint64_t>(n, size_ - offset);
+    auto status_or_response = client_->get(
+        uri_, absl::StrFormat("Range: bytes=%d-%d\r\n", offset, offset + n - 1), dst, n);
+    if (!status_or_response.ok()) {
+      return status_or_response.status();
+    }
+    if (status_or_response->status != 206 || status_or_response->oversized) {
+      return absl::InternalError(absl::StrFormat("GET %s bytes %d-%d: HTTP %d %s", uri_, offset,
+                                                 offset + n - 1, status_or_response->status,
+                                                 status_or_response->body.substr(0, 256)));
+    }
+    return status_or_response->body_size;
+  }
+
+ private:
+  std::string uri_;
+  uint64_t size_;
+  std::shared_ptr<HttpClient> client_;
+};
+
+/**
+ * @brief HttpFileSystem opens "http://" uris. The size of a file is taken from the Content-Range
+ * of a one byte range request, which also checks that the server supports ranges. https is not
+ * supported.
+ */
+class HttpFileSystem final : public FileSystem {
+ public:
+  explicit HttpFileSystem(const HttpOptions& options = {})
+      : client_(std::make_shared<HttpClient>(options)) {}
+
+  absl::StatusOr<std::unique_ptr<RandomAccessFile>> open(const std::string& uri) final {
+    char first_byte;
+    auto status_or_response = client_->get(uri, "Range: bytes=0-0\r\n", &first_byte, 1);
+    if (!status_or_response.ok()) {
+      return status_or_response.status();
+    }
+    const HttpResponse& response = status_or_response.value();
+    if (response.status == 404) {
+      return absl::NotFoundError(absl::StrFormat("Failed to open file: %s: HTTP 404", uri));
+    }
+    if (response.status == 200 || (response.status == 206 && response.oversized)) {
+      return absl::FailedPreconditionError(
+          absl::StrFormat("Server of %s does not support range requests", uri));
+    }
+    if (response.status != 206 && response.status != 416) {
+      return absl::InternalError(absl::StrFormat("Failed to open file: %s: HTTP %d %s", uri,
+                                                 response.status, response.body.substr(0, 256)));
+    }
+    // Content-Range: bytes 0-0/1234，空文件返回 416 与 bytes */0
+    const std::string* range = response.header("content-range");
+    size_t slash = range == nullptr ? std::string::npos : range->rfind('/');
+    uint64_t size = 0;
+    if (slash == std::string::npos ||
+        std::from_chars(range->data() + slash + 1, range->data() + range->size(), size).ec !=
+            std::errc()) {
+      return absl::InternalError(absl::StrFormat("Missing file size in response for %s", uri));
+    }
+    VLOG(3) << "[HttpFileSystem] opened " << uri << ", " << size << " bytes";
+    return std::make_unique<HttpRandomAccessFile>(uri, size, client_);
+  }
+
+ private:
+  std::shared_ptr<HttpClient> client_;
+};
+
+}  // namespace data_flow
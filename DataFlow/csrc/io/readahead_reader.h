@@ -0,0 +1,335 @@
+/**
+ * @file readahead_reader.h
+ * @brief Definition of ReadaheadReader, a sequential reader of a RandomAccessFile that keeps many
+ * range reads in flight.
+ *
+ * Author: Jasmine (1011694931@qq.com)
+ * Created on: 2025-11-17
+ *
+ * Copyright (c) 2025 Jasmine. All rights reserved.
+ */
+
+#pragma once
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "glog/logging.h"
+
+#include "DataFlow/csrc/common/threads.h"
+#include "DataFlow/csrc/coro/scheduler.h"
+#include "DataFlow/csrc/io/file_system.h"
+
+namespace data_flow {
+
+/**
+ * @brief Options of ReadaheadReader. With latency L per request and bandwidth B per connection,
+ * a window of chunk_size * window bytes and num_threads >= L * aggregate rate / chunk_size keep
+ * the link busy.
+ */
+struct ReadaheadOptions {
+  size_t chunk_size = 4 << 20;
+  // 最多预读的 chunk 数
+  size_t window = 8;
+  // 并发的 range 请求数，同一 ReadaheadPool 上的所有文件共享
+  size_t num_threads = 4;
+  // 每个 chunk 失败后的重试次数
+  int max_retries = 3;
+};
+
+/**
+ * @brief ReadaheadPool runs the range reads of ReadaheadReaders on at most num_threads threads.
+ * Readers sharing a pool (e.g. every remote file of a DataReader) share its threads, so many files
+ * open at once do not each hold threads of their own. Threads are started on demand.
+ */
+class ReadaheadPool {
+ public:
+  explicit ReadaheadPool(size_t num_threads) : num_threads_(std::max<size_t>(num_threads, 1)) {}
+
+  ~ReadaheadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  ReadaheadPool(const ReadaheadPool&) = delete;
+  ReadaheadPool& operator=(const ReadaheadPool&) = delete;
+
+  size_t num_threads() const { return num_threads_; }
+
+  void submit(std::function<void()> task) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks_.push_back(std::move(task));
+      if (idle_ < tasks_.size() && workers_.size() < num_threads_) {
+        workers_.push_back(Threads::Start([this] { run(); }));
+      }
+    }
+    cv_.notify_one();
+  }
+
+ private:
+  void run() {
+    while (true) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ++idle_;
+        cv_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+        --idle_;
+        if (tasks_.empty()) {
+          return;
+        }
+        task = std::move(tasks_.front());
+        tasks_.pop_front();
+      }
+      task();
+    }
+  }
+
+  const size_t num_threads_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::function<void()>> tasks_;
+  size_t idle_ = 0;
+  bool stop_ = false;
+  std::vector<std::thread> workers_;
+};
+
+/**
+ * @brief ReadaheadReader reads a file sequentially while the next `window` chunks are fetched with
+ * concurrent range reads, at most num_threads of them at a time, on a ReadaheadPool. Chunk i is
+ * fetched into slot i % window, a slot is reused once the consumer has moved past its chunk, so
+ * memory stays at chunk_size * window.
+ *
+ * Every fetched chunk is also signalled on an eventfd, so read_async() can wait for a chunk in a
+ * Scheduler's epoll instead of blocking a thread.
+ */
+class ReadaheadReader {
+ public:
+  /**
+   * @param pool Pool running the fetches, shared with other readers; a pool of
+   * options.num_threads threads owned by this reader if null.
+   */
+  ReadaheadReader(std::unique_ptr<RandomAccessFile> file, const ReadaheadOptions& options = {},
+                  std::shared_ptr<ReadaheadPool> pool = nullptr)
+      : file_(std::move(file)),
+        options_(options),
+        num_chunks_((file_->size() + options_.chunk_size - 1) / options_.chunk_size),
+        pool_(pool != nullptr ? std::move(pool)
+                              : std::make_shared<ReadaheadPool>(options_.num_threads)),
+        slots_(std::max<size_t>(options_.window, 1)),
+        ready_fd_(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) {
+    CHECK_GE(ready_fd_, 0) << "Failed to create eventfd: " << std::strerror(errno);
+    options_.window = slots_.size();
+    options_.num_threads = std::max<size_t>(options_.num_threads, 1);
+    std::lock_guard<std::mutex> lock(mutex_);
+    schedule_locked();
+  }
+
+  ~ReadaheadReader() {
+    {
+      // 等待已提交的 fetch 结束，它们持有 this
+      std::unique_lock<std::mutex> lock(mutex_);
+      stop_ = true;
+      stop_cv_.notify_all();
+      idle_cv_.wait(lock, [this] { return in_flight_ == 0; });
+    }
+    ::close(ready_fd_);
+  }
+
+  ReadaheadReader(const ReadaheadReader&) = delete;
+  ReadaheadReader& operator=(const ReadaheadReader&) = delete;
+
+  const std::string& uri() const { return file_->uri(); }
+  uint64_t size() const { return file_->size(); }
+
+  /**
+   * @brief Read the next bytes of the file into dst, waiting for chunks still being fetched.
+   * @return Number of bytes read, less than n only at the end of the file; the error of a chunk
+   * that failed after all retries.
+   */
+  absl::StatusOr<size_t> read(char* dst, size_t n) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return read_locked(lock, dst, n, /*wait=*/true);
+  }
+
+  /**
+   * @brief Asynchronous read(): waits in the scheduler's epoll until the next chunk is fetched,
+   * then returns the bytes of the chunks fetched so far.
+   */
+  Task<absl::StatusOr<size_t>> read_async(Scheduler& scheduler, char* dst, size_t n) {
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (consumed_ >= num_chunks_ || slots_[consumed_ % options_.window].chunk == consumed_) {
+          co_return read_locked(lock, dst, n, /*wait=*/false);
+        }
+      }
+      auto status = co_await scheduler.readable(ready_fd_);
+      if (!status.ok()) {
+        co_return status;
+      }
+      uint64_t count;
+      (void)::read(ready_fd_, &count, sizeof(count));
+    }
+  }
+
+ private:
+  static constexpr uint64_t kNoChunk = ~uint64_t{0};
+
+  struct Slot {
+    std::vector<char> data;
+    size_t size = 0;
+    // slot 中已就绪的 chunk 序号
+    uint64_t chunk = kNoChunk;
+    absl::Status status;
+  };
+
+  /**
+   * @brief Copy up to n bytes of fetched chunks into dst. With wait, waits for chunks still being
+   * fetched; without, stops at the first of them.
+   */
+  absl::StatusOr<size_t> read_locked(std::unique_lock<std::mutex>& lock, char* dst, size_t n,
+                                     bool wait) {
+    size_t done = 0;
+    while (done < n && consumed_ < num_chunks_) {
+      Slot& slot = slots_[consumed_ % options_.window];
+      if (!wait && slot.chunk != consumed_) {
+        break;
+      }
+      ready_cv_.wait(lock, [&] { return slot.chunk == consumed_; });
+      if (!slot.status.ok()) {
+        return slot.status;
+      }
+      const size_t size = std::min(n - done, slot.size - offset_);
+      std::memcpy(dst + done, slot.data.data() + offset_, size);
+      done += size;
+      offset_ += size;
+      if (offset_ == slot.size) {
+        // 释放 slot，预读下一个 chunk
+        slot.chunk = kNoChunk;
+        offset_ = 0;
+        ++consumed_;
+        schedule_locked();
+      }
+    }
+    return done;
+  }
+
+  /**
+   * @brief Submit fetches of the next chunks while the window has room and fewer than num_threads
+   * fetches of this reader are in flight.
+   */
+  void schedule_locked() {
+    while (!stop_ && in_flight_ < options_.num_threads && next_chunk_ < num_chunks_ &&
+           next_chunk_ < consumed_ + options_.window) {
+      ++in_flight_;
+      pool_->submit([this, chunk = next_chunk_++] { fetch_chunk(chunk); });
+    }
+  }
+
+  void fetch_chunk(uint64_t chunk) {
+    // slot 在 consumer 读到该 chunk 之前只属于当前 fetch，无需加锁
+    Slot& slot = slots_[chunk % options_.window];
+    const uint64_t offset = chunk * options_.chunk_size;
+    const size_t size = std::min<uint64_t>(options_.chunk_size, file_->size() - offset);
+    slot.data.resize(options_.chunk_size);
+    absl::Status status = fetch(offset, size, slot.data.data());
+
+    // 解锁后 this 可能已被析构，通知均在锁内完成
+    std::lock_guard<std::mutex> lock(mutex_);
+    slot.size = size;
+    slot.status = std::move(status);
+    slot.chunk = chunk;
+    ready_cv_.notify_all();
+    uint64_t one = 1;
+    (void)::write(ready_fd_, &one, sizeof(one));
+    --in_flight_;
+    schedule_locked();
+    if (in_flight_ == 0) {
+      idle_cv_.notify_all();
+    }
+  }
+
+  /**
+   * @brief Read a chunk, retrying failed reads with exponential backoff. Gives up with Cancelled
+   * once the reader is being destroyed, before any attempt or during a backoff.
+   */
+  absl::Status fetch(uint64_t offset, size_t size, char* dst) {
+    absl::Status status;
+    for (int attempt = 0; attempt <= options_.max_retries; ++attempt) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (attempt > 0) {
+          LOG(WARNING) << "[ReadaheadReader] retrying " << file_->uri() << " at " << offset << ": "
+                       << status;
+          stop_cv_.wait_for(lock, std::chrono::milliseconds(50 << std::min(attempt, 6)),
+                            [this] { return stop_; });
+        }
+        if (stop_) {
+          return absl::CancelledError(
+              absl::StrFormat("ReadaheadReader of %s destroyed", file_->uri()));
+        }
+      }
+      auto status_or_size = file_->read(offset, size, dst);
+      if (status_or_size.ok() && status_or_size.value() == size) {
+        return absl::OkStatus();
+      }
+      status = status_or_size.ok()
+                   ? absl::DataLossError(absl::StrFormat("Short read of %s at %d: %d of %d bytes",
+                                                         file_->uri(), offset,
+                                                         status_or_size.value(), size))
+                   : status_or_size.status();
+      if (absl::IsNotFound(status) || absl::IsUnimplemented(status)) {
+        break;
+      }
+    }
+    return status;
+  }
+
+  std::unique_ptr<RandomAccessFile> file_;
+  ReadaheadOptions options_;
+  const uint64_t num_chunks_;
+
+  std::shared_ptr<ReadaheadPool> pool_;
+
+  std::mutex mutex_;
+  std::condition_variable ready_cv_;
+  // 析构时等待 in_flight_ 归零
+  std::condition_variable idle_cv_;
+  // 析构时唤醒重试前的退避等待
+  std::condition_variable stop_cv_;
+  std::vector<Slot> slots_;
+  // 下一个待预读的 chunk
+  uint64_t next_chunk_ = 0;
+  // 已提交到 pool 尚未完成的 fetch 数
+  size_t in_flight_ = 0;
+  // consumer 正在读的 chunk 及其中的偏移
+  uint64_t consumed_ = 0;
+  size_t offset_ = 0;
+  bool stop_ = false;
+  // 每个 chunk 就绪时加一，供 read_async 在 epoll 中等待
+  int ready_fd_;
+};
+
+}  // namespace data_flow
@@ -0,0 +1,285 @@
+/**
+ * @file stream_file.h
+ * @brief Definition of StreamFile, a non-blocking reader of FIFOs, Unix domain sockets and stdin.
+ *
+ * Author: Jasmine (1011694931@qq.com)
+ * Created on: 2025-11-11
+ *
+ * Copyright (c) 2025 Jasmine. All rights reserved.
+ */
+
+#pragma once
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "glog/logging.h"
+
+#include "DataFlow/csrc/common/functions.h"
+#include "DataFlow/csrc/coro/scheduler.h"
+
+namespace data_flow {
+
+/**
+ * @brief Options of StreamFile.
+ */
+struct StreamFileOptions {
+  // FIFO only: keep reading when the writer closes, so that producers can come and go and the
+  // stream never ends.
+  bool follow = false;
+  // Fail with DeadlineExceeded if no data arrives for this long, -1 waits forever.
+  int64_t idle_timeout_ms = -1;
+  // FIFO only: requested pipe capacity, a larger pipe absorbs producer bursts.
+  int pipe_size = 1 << 20;
+};
+
+/**
+ * @brief StreamFile reads a never-ending byte stream: a FIFO, a Unix domain socket or stdin.
+ *
+ * Supported uris:
+ * - "-" or "stdin://": standard input.
+ * - "unix://<path>": connect to a listening SOCK_STREAM Unix domain socket.
+ * - "fifo://<path>" or the path of a FIFO.
+ *
+ * The descriptor is non-blocking and read() waits for data with epoll. stdin is left blocking, as
+ * its file status flags are shared with the rest of the process and the parent shell, and is only
+ * read after epoll reports it readable. Data is read straight into
+ * the caller's buffer and only when the caller asks for it, so a slow consumer leaves data in the
+ * kernel pipe/socket buffer and the producer blocks once that buffer is full (backpressure).
+ */
+class StreamFile {
+ public:
+  /**
+   * @brief Whether uri names a stream rather than a regular file.
+   */
+  static bool IsStreamUri(const std::string& uri) {
+    if (uri == "-" || uri == "stdin://" || Func::starts_with(uri, "unix://") ||
+        Func::starts_with(uri, "fifo://")) {
+      return true;
+    }
+    struct stat st;
+    return ::stat(uri.c_str(), &st) == 0 && (S_ISFIFO(st.st_mode) || S_ISSOCK(st.st_mode));
+  }
+
+  static absl::StatusOr<std::unique_ptr<StreamFile>> Open(const std::string& uri,
+                                                          const StreamFileOptions& options = {}) {
+    std::unique_ptr<StreamFile> file(new StreamFile(uri, options));
+    absl::Status status;
+    if (uri == "-" || uri == "stdin://") {
+      status = file->open_stdin();
+    } else if (Func::starts_with(uri, "unix://")) {
+      status = file->open_unix_socket(uri.substr(std::strlen("unix://")));
+    } else {
+      std::string path =
+          Func::starts_with(uri, "fifo://") ? uri.substr(std::strlen("fifo://")) : uri;
+      struct stat st;
+      if (::stat(path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode)) {
+        status = file->open_unix_socket(path);
+      } else {
+        status = file->open_fifo(path);
+      }
+    }
+    if (status.ok()) {
+      status = file->register_epoll();
+    }
+    if (!status.ok()) {
+      return status;
+    }
+    VLOG(3) << "[StreamFile] opened " << uri;
+    return file;
+  }
+
+  ~StreamFile() {
+    for (int fd : {fd_, keepalive_fd_, epoll_fd_}) {
+      if (fd >= 0) {
+        ::close(fd);
+      }
+    }
+  }
+
+  StreamFile(const StreamFile&) = delete;
+  StreamFile& operator=(const StreamFile&) = delete;
+
+  const std::string& uri() const { return uri_; }
+
+  /**
+   * @brief Read up to size bytes, waiting until at least one byte is available.
+   * @return Number of bytes read, 0 at end of stream.
+   */
+  absl::StatusOr<size_t> read(char* buffer, size_t size) {
+    // FIFO 在写端连接前 read 会直接返回 0，阻塞的 stdin 每次都需先等待可读
+    bool ready = connected_ && !blocking_;
+    while (true) {
+      if (ready) {
+        ssize_t n = ::read(fd_, buffer, size);
+        if (n >= 0) {
+          return static_cast<size_t>(n);
+        }
+        if (errno == EINTR) {
+          continue;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+          return absl::InternalError(
+              absl::StrFormat("Failed to read %s: %s", uri_, std::strerror(errno)));
+        }
+      }
+
+      auto status = wait_readable();
+      if (!status.ok()) {
+        return status;
+      }
+      connected_ = true;
+      ready = true;
+    }
+  }
+
+  /**
+   * @brief Asynchronous read(): instead of blocking in epoll_wait, the coroutine waits for the
+   * descriptor in the scheduler's epoll, for at most idle_timeout_ms like read(). Cancelled when
+   * the scheduler cancels its waits.
+   */
+  Task<absl::StatusOr<size_t>> read_async(Scheduler& scheduler, char* buffer, size_t size) {
+    bool ready = connected_ && !blocking_;
+    while (true) {
+      if (ready) {
+        ssize_t n = ::read(fd_, buffer, size);
+        if (n >= 0) {
+          co_return static_cast<size_t>(n);
+        }
+        if (errno == EINTR) {
+          continue;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+          co_return absl::InternalError(
+              absl::StrFormat("Failed to read %s: %s", uri_, std::strerror(errno)));
+        }
+      }
+
+      auto status = co_await scheduler.readable(fd_, options_.idle_timeout_ms);
+      if (absl::IsDeadlineExceeded(status)) {
+        co_return idle_timeout_error();
+      }
+      if (!status.ok()) {
+        co_return status;
+      }
+      connected_ = true;
+      ready = true;
+    }
+  }
+
+ private:
+  StreamFile(const std::string& uri, const StreamFileOptions& options)
+      : uri_(uri), options_(options) {}
+
+  absl::Status open_stdin() {
+    fd_ = ::dup(STDIN_FILENO);
+    if (fd_ < 0) {
+      return absl::InternalError(absl::StrFormat("Failed to dup stdin: %s", std::strerror(errno)));
+    }
+    connected_ = true;
+    blocking_ = true;
+    return absl::OkStatus();
+  }
+
+  absl::Status open_unix_socket(const std::string& path) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) {
+      return absl::InvalidArgumentError(absl::StrFormat("Unix socket path too long: %s", path));
+    }
+    std::memcpy(addr.sun_path, path.data(), path.size());
+
+    fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd_ < 0 || ::connect(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+      return absl::UnavailableError(
+          absl::StrFormat("Failed to connect to %s: %s", path, std::strerror(errno)));
+    }
+    connected_ = true;
+    return set_non_blocking();
+  }
+
+  absl::Status open_fifo(const std::string& path) {
+    fd_ = ::open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd_ < 0) {
+      return absl::NotFoundError(
+          absl::StrFormat("Failed to open FIFO %s: %s", path, std::strerror(errno)));
+    }
+    if (options_.pipe_size > 0 && ::fcntl(fd_, F_SETPIPE_SZ, options_.pipe_size) < 0) {
+      VLOG(3) << "[StreamFile] failed to resize pipe of " << path << ": " << std::strerror(errno);
+    }
+    if (options_.follow) {
+      // 自己持有一个写端，写者关闭时读端不会看到 EOF
+      keepalive_fd_ = ::open(path.c_str(), O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+      if (keepalive_fd_ < 0) {
+        return absl::InternalError(
+            absl::StrFormat("Failed to open FIFO %s for writing: %s", path, std::strerror(errno)));
+      }
+    }
+    return absl::OkStatus();
+  }
+
+  absl::Status set_non_blocking() {
+    int flags = ::fcntl(fd_, F_GETFL);
+    if (flags < 0 || ::fcntl(fd_, F_SETFL, flags | O_NONBLOCK) < 0) {
+      return absl::InternalError(
+          absl::StrFormat("Failed to set %s non-blocking: %s", uri_, std::strerror(errno)));
+    }
+    return absl::OkStatus();
+  }
+
+  absl::Status register_epoll() {
+    epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLRDHUP;
+    event.data.fd = fd_;
+    if (epoll_fd_ < 0 || ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd_, &event) != 0) {
+      return absl::InternalError(
+          absl::StrFormat("Failed to register %s with epoll: %s", uri_, std::strerror(errno)));
+    }
+    return absl::OkStatus();
+  }
+
+  absl::Status wait_readable() {
+    epoll_event event;
+    while (true) {
+      int n = ::epoll_wait(epoll_fd_, &event, 1, static_cast<int>(options_.idle_timeout_ms));
+      if (n > 0) {
+        return absl::OkStatus();
+      }
+      if (n == 0) {
+        return idle_timeout_error();
+      }
+      if (errno != EINTR) {
+        return absl::InternalError(
+            absl::StrFormat("epoll_wait on %s failed: %s", uri_, std::strerror(errno)));
+      }
+    }
+  }
+
+  absl::Status idle_timeout_error() const {
+    return absl::DeadlineExceededError(
+        absl::StrFormat("No data from %s for %d ms", uri_, options_.idle_timeout_ms));
+  }
+
+  std::string uri_;
+  StreamFileOptions options_;
+  int fd_ = -1;
+  int keepalive_fd_ = -1;
+  int epoll_fd_ = -1;
+  bool connected_ = false;
+  // stdin 不设置 O_NONBLOCK，只在 epoll 报告可读后读取
+  bool blocking_ = false;
+};
+
+}  // namespace data_flow
@@ -0,0 +1,175 @@
+/**
+ * @file webhdfs_file_system.h
+ * @brief Definition of WebHdfsFileSystem, reading HDFS files through the WebHDFS REST API.
+ *
+ * Author: Jasmine (1011694931@qq.com)
+ * Created on: 2025-11-17
+ *
+ * Copyright (c) 2025 Jasmine. All rights reserved.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "glog/logging.h"
+
+#include "DataFlow/csrc/io/file_system.h"
+#include "DataFlow/csrc/io/http_file_system.h"
+
+namespace data_flow {
+
+/**
+ * @brief HDFS file read with "op=OPEN&offset=..&length=.." requests. The namenode answers with a
+ * 307 redirect to a datanode holding the block, which HttpClient follows.
+ */
+class WebHdfsRandomAccessFile final : public RandomAccessFile {
+ public:
+  WebHdfsRandomAccessFile(std::string uri, std::string url, std::string user_query, uint64_t size,
+                          std::shared_ptr<HttpClient> client)
+      : uri_(std::move(uri)),
+        url_(std::move(url)),
+        user_query_(std::move(user_query)),
+        size_(size),
+        client_(std::move(client)) {}
+
+  const std::string& uri() const final { return uri_; }
+  uint64_t size() const final { return size_; }
+
+  absl::StatusOr<size_t> read(uint64_t offset, size_t n, char* dst) final {
+    if (offset >= size_ || n == 0) {
+      return 0;
+    }
+    n = std::min<uint64_t>(n, size_ - offset);
+    auto status_or_response = client_->get(
+        absl::StrFormat("%s?op=OPEN&offset=%d&length=%d%s", url_, offset, n, user_query_), "",
+        dst, n);
+    if (!status_or_response.ok()) {
+      return status_or_response.status();
+    }
+    if (status_or_response->status != 200 || status_or_response->oversized) {
+      return absl::InternalError(absl::StrFormat("WebHDFS OPEN %s at %d: HTTP %d %s", uri_, offset,
+                                                 status_or_response->status,
+                                                 status_or_response->body.substr(0, 256)));
+    }
+    return status_or_response->body_size;
+  }
+
+ private:
+  std::string uri_;
+  std::string url_;
+  std::string user_query_;
+  uint64_t size_;
+  std::shared_ptr<HttpClient> client_;
+};
+
+/**
+ * @brief WebHdfsFileSystem opens "webhdfs://namenode:port/path" and "hdfs://namenode:port/path".
+ * Both are served over the namenode's HTTP port (9870 by default), since there is no native HDFS
+ * RPC client; the user is taken from HADOOP_USER_NAME when set.
+ */
+class WebHdfsFileSystem final : public FileSystem {
+ public:
+  static constexpr uint16_t kDefaultPort = 9870;
+
+  explicit WebHdfsFileSystem(const HttpOptions& options = {})
+      : client_(std::make_shared<HttpClient>(options)) {
+    if (const char* user = std::getenv("HADOOP_USER_NAME"); user != nullptr && *user != '\0') {
+      user_query_ = absl::StrFormat("&user.name=%s", PercentEncode(user));
+    }
+  }
+
+  absl::StatusOr<std::unique_ptr<RandomAccessFile>> open(const std::string& uri) final {
+    auto status_or_url = HttpUrl::Parse(uri, kDefaultPort);
+    if (!status_or_url.ok()) {
+      return status_or_url.status();
+    }
+    const HttpUrl& parsed = status_or_url.value();
+    std::string path = parsed.target.substr(0, parsed.target.find('?'));
+    std::string url = absl::StrFormat("http://%s/webhdfs/v1%s", parsed.authority(),
+                                      PercentEncode(path));
+
+    auto status_or_response =
+        client_->get(absl::StrFormat("%s?op=GETFILESTATUS%s", url, user_query_));
+    if (!status_or_response.ok()) {
+      return status_or_response.status();
+    }
+    const HttpResponse& response = status_or_response.value();
+    if (response.status == 404) {
+      return absl::NotFoundError(absl::StrFormat("Failed to open file: %s: %s", uri,
+                                                 JsonField(response.body, "message")));
+    }
+    if (response.status != 200) {
+      return absl::InternalError(absl::StrFormat("WebHDFS GETFILESTATUS %s: HTTP %d %s", uri,
+                                                 response.status, response.body.substr(0, 256)));
+    }
+    if (JsonField(response.body, "type") == "DIRECTORY") {
+      return absl::InvalidArgumentError(absl::StrFormat("%s is a directory", uri));
+    }
+    std::string length = JsonField(response.body, "length");
+    uint64_t size = 0;
+    if (std::from_chars(length.data(), length.data() + length.size(), size).ec != std::errc()) {
+      return absl::InternalError(
+          absl::StrFormat("Missing file length in FileStatus of %s: %s", uri, response.body));
+    }
+    VLOG(3) << "[WebHdfsFileSystem] opened " << uri << ", " << size << " bytes";
+    return std::make_unique<WebHdfsRandomAccessFile>(uri, std::move(url), user_query_, size,
+                                                     client_);
+  }
+
+ private:
+  /**
+   * @brief Percent-encode everything except unreserved characters and '/'.
+   */
+  static std::string PercentEncode(std::string_view s) {
+    std::string encoded;
+    for (unsigned char c : s) {
+      if (std::isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~' || c == '/') {
+        encoded += static_cast<char>(c);
+      } else {
+        encoded += absl::StrFormat("%%%02X", c);
+      }
+    }
+    return encoded;
+  }
+
+  /**
+   * @brief Value of the first `"name":` field of a flat JSON object, without quotes. FileStatus
+   * and RemoteException replies are small and flat, so no JSON parser is needed.
+   */
+  static std::string JsonField(std::string_view json, std::string_view name) {
+    std::string key = absl::StrFormat("\"%s\"", name);
+    size_t pos = json.find(key);
+    if (pos == std::string_view::npos) {
+      return "";
+    }
+    pos = json.find(':', pos + key.size());
+    if (pos == std::string_view::npos) {
+      return "";
+    }
+    pos = json.find_first_not_of(" \t\r\n", pos + 1);
+    if (pos == std::string_view::npos) {
+      return "";
+    }
+    if (json[pos] == '"') {
+      size_t end = json.find('"', pos + 1);
+      return std::string(json.substr(pos + 1, end == std::string_view::npos ? end : end - pos - 1));
+    }
+    size_t end = json.find_first_of(",} \t\r\n", pos);
+    return std::string(json.substr(pos, end == std::string_view::npos ? end : end - pos));
+  }
+
+  std::shared_ptr<HttpClient> client_;
+  std::string user_query_;
+};
+
+}  // namespace data_flow
@@ -0,0 +1,304 @@
+/**
+ * @file shm_ring.h
+ * @brief Definition of ShmRing, a ring of fixed-size shared memory slots shared with forked
+ * worker processes.
+ *
+ * Author: Jasmine (1011694931@qq.com)
+ * Created on: 2025-11-14
+ *
+ * Copyright (c) 2025 Jasmine. All rights reserved.
+ */
+
+#pragma once
+
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <limits>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "glog/logging.h"
+
+namespace data_flow {
+
+/**
+ * @brief Options of ShmRing.
+ */
+struct ShmRingOptions {
+  // slots in flight: filled by workers, queued, or held by the consumer
+  size_t num_slots = 16;
+  // bytes per slot, an encoded batch must fit in one slot
+  size_t slot_size = 16 << 20;
+};
+
+/**
+ * @brief ShmRing is a memfd mapping holding num_slots slots of slot_size bytes and their states,
+ * created before fork() so that worker processes inherit it.
+ *
+ * Slot life cycle: kFree -> acquire() by a worker -> kWriting -> publish() -> kReady -> take() by
+ * the consumer -> kReading -> release() -> kFree. A slot being written also holds the id of its
+ * worker in the same atomic state word, so the slots of a dead worker are always found and freed.
+ * Blocked workers and the consumer sleep on two futex event counters in the shared header, bumped
+ * on every release and publish.
+ */
+class ShmRing {
+ public:
+  static constexpr uint32_t kNoSlot = std::numeric_limits<uint32_t>::max();
+  static constexpr size_t kMaxErrorLength = 512;
+
+  static absl::StatusOr<std::shared_ptr<ShmRing>> Create(size_t num_workers,
+                                                          const ShmRingOptions& options) {
+    if (options.num_slots == 0 || options.slot_size == 0) {
+      return absl::InvalidArgumentError("num_slots and slot_size must be positive");
+    }
+    if (num_workers >= (1u << (32 - kOwnerShift))) {
+      return absl::InvalidArgumentError(absl::StrFormat("Too many workers: %d", num_workers));
+    }
+    std::shared_ptr<ShmRing> ring(new ShmRing(num_workers, options));
+    auto status = ring->map();
+    if (!status.ok()) {
+      return status;
+    }
+    return ring;
+  }
+
+  ~ShmRing() {
+    if (base_ != nullptr) {
+      ::munmap(base_, mapped_size_);
+    }
+  }
+
+  ShmRing(const ShmRing&) = delete;
+  ShmRing& operator=(const ShmRing&) = delete;
+
+  size_t num_slots() const { return num_slots_; }
+  size_t slot_size() const { return slot_size_; }
+  char* slot_data(uint32_t slot) const { return slots_ + slot * slot_size_; }
+  size_t slot_bytes(uint32_t slot) const { return states_[slot].bytes; }
+
+  // ---- worker side ----
+
+  /**
+   * @brief Claim a free slot for writing, waiting until the consumer releases one.
+   * @return The slot, or Cancelled once stop() has been called.
+   */
+  absl::StatusOr<uint32_t> acquire(uint32_t worker) {
+    while (true) {
+      const uint32_t events = header_->free_events.load(std::memory_order_acquire);
+      if (header_->stopped.load(std::memory_order_acquire)) {
+        return absl::CancelledError("ShmRing stopped");
+      }
+      for (uint32_t slot = 0; slot < num_slots_; ++slot) {
+        uint32_t expected = kFree;
+        if (states_[slot].state.compare_exchange_strong(expected, Writing(worker),
+                                                        std::memory_order_acquire)) {
+          return slot;
+        }
+      }
+      FutexWait(&header_->free_events, events, -1);
+    }
+  }
+
+  /**
+   * @brief Hand a filled slot over to the consumer.
+   */
+  void publish(uint32_t slot, size_t bytes) {
+    states_[slot].bytes = bytes;
+    states_[slot].seq = header_->next_seq.fetch_add(1, std::memory_order_relaxed);
+    states_[slot].state.store(kReady, std::memory_order_release);
+    header_->ready_events.fetch_add(1, std::memory_order_release);
+    FutexWake(&header_->ready_events);
+  }
+
+  void set_worker_error(uint32_t worker, std::string_view message) {
+    char* error = errors_ + worker * kMaxErrorLength;
+    const size_t size = std::min(message.size(), kMaxErrorLength - 1);
+    std::memcpy(error, message.data(), size);
+    error[size] = '\0';
+  }
+
+  // ---- consumer side ----
+
+  uint32_t ready_events() const { return header_->ready_events.load(std::memory_order_acquire); }
+
+  /**
+   * @brief Take the oldest ready slot without waiting.
+   * @return The slot, or kNoSlot if none is ready.
+   */
+  uint32_t take() {
+    uint32_t oldest = kNoSlot;
+    for (uint32_t slot = 0; slot < num_slots_; ++slot) {
+      if (states_[slot].state.load(std::memory_order_acquire) == kReady &&
+          (oldest == kNoSlot || states_[slot].seq < states_[oldest].seq)) {
+        oldest = slot;
+      }
+    }
+    if (oldest != kNoSlot) {
+      states_[oldest].state.store(kReading, std::memory_order_relaxed);
+    }
+    return oldest;
+  }
+
+  /**
+   * @brief Whether the consumer holds every slot, so that no worker can publish anything until it
+   * releases one.
+   */
+  bool all_reading() const {
+    for (uint32_t slot = 0; slot < num_slots_; ++slot) {
+      if (states_[slot].state.load(std::memory_order_acquire) != kReading) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Wait until ready_events() moves past `events`, at most timeout_ms milliseconds.
+   */
+  void wait_ready(uint32_t events, int64_t timeout_ms) {
+    FutexWait(&header_->ready_events, events, timeout_ms);
+  }
+
+  void release(uint32_t slot) {
+    states_[slot].state.store(kFree, std::memory_order_release);
+    header_->free_events.fetch_add(1, std::memory_order_release);
+    FutexWake(&header_->free_events);
+  }
+
+  /**
+   * @brief Free the slots a dead worker was writing.
+   */
+  void reclaim(uint32_t worker) {
+    for (uint32_t slot = 0; slot < num_slots_; ++slot) {
+      uint32_t expected = Writing(worker);
+      if (states_[slot].state.compare_exchange_strong(expected, kFree,
+                                                      std::memory_order_acquire)) {
+        header_->free_events.fetch_add(1, std::memory_order_release);
+        FutexWake(&header_->free_events);
+      }
+    }
+  }
+
+  std::string worker_error(uint32_t worker) const {
+    return std::string(errors_ + worker * kMaxErrorLength);
+  }
+
+  /**
+   * @brief Make blocked and future acquire() calls fail.
+   */
+  void stop() {
+    header_->stopped.store(1, std::memory_order_release);
+    header_->free_events.fetch_add(1, std::memory_order_release);
+    FutexWake(&header_->free_events);
+  }
+
+ private:
+  enum SlotState : uint32_t { kFree = 0, kWriting, kReady, kReading };
+  // 状态字低 8 位为 SlotState，kWriting 时高位为 worker 编号
+  static constexpr uint32_t kOwnerShift = 8;
+
+  static uint32_t Writing(uint32_t worker) { return kWriting | (worker << kOwnerShift); }
+
+  struct Header {
+    std::atomic<uint32_t> ready_events;
+    std::atomic<uint32_t> free_events;
+    std::atomic<uint32_t> stopped;
+    std::atomic<uint64_t> next_seq;
+  };
+
+  struct alignas(64) Slot {
+    std::atomic<uint32_t> state;
+    uint64_t seq;
+    uint64_t bytes;
+  };
+
+  static_assert(std::atomic<uint32_t>::is_always_lock_free &&
+                    std::atomic<uint64_t>::is_always_lock_free,
+                "atomics shared between processes must be lock free");
+
+  static constexpr size_t kPageSize = 4096;
+
+  static size_t AlignUp(size_t size, size_t alignment) {
+    return (size + alignment - 1) / alignment * alignment;
+  }
+
+  // 跨进程共享，不能使用 FUTEX_PRIVATE_FLAG
+  static void FutexWait(std::atomic<uint32_t>* word, uint32_t expected, int64_t timeout_ms) {
+    timespec timeout{};
+    timeout.tv_sec = timeout_ms / 1000;
+    timeout.tv_nsec = (timeout_ms % 1000) * 1000000;
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, expected,
+              timeout_ms < 0 ? nullptr : &timeout, nullptr, 0);
+  }
+
+  static void FutexWake(std::atomic<uint32_t>* word) {
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE,
+              std::numeric_limits<int>::max(), nullptr, nullptr, 0);
+  }
+
+  ShmRing(size_t num_workers, const ShmRingOptions& options)
+      : num_workers_(num_workers),
+        num_slots_(options.num_slots),
+        slot_size_(AlignUp(options.slot_size, kPageSize)) {}
+
+  absl::Status map() {
+    const size_t header_size = sizeof(Header);
+    const size_t states_offset = AlignUp(header_size, alignof(Slot));
+    const size_t errors_offset = states_offset + num_slots_ * sizeof(Slot);
+    const size_t slots_offset = AlignUp(errors_offset + num_workers_ * kMaxErrorLength, kPageSize);
+    mapped_size_ = slots_offset + num_slots_ * slot_size_;
+
+    int fd = ::memfd_create("data_flow_shm_ring", MFD_CLOEXEC);
+    if (fd < 0) {
+      return absl::InternalError(absl::StrFormat("memfd_create failed: %s", std::strerror(errno)));
+    }
+    if (::ftruncate(fd, mapped_size_) != 0) {
+      ::close(fd);
+      return absl::ResourceExhaustedError(absl::StrFormat(
+          "Failed to size shared memory to %d bytes: %s", mapped_size_, std::strerror(errno)));
+    }
+    void* base = ::mmap(nullptr, mapped_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    // 映射建立后即可关闭 fd，fork 出的子进程继承映射本身
+    ::close(fd);
+    if (base == MAP_FAILED) {
+      return absl::InternalError(absl::StrFormat("mmap failed: %s", std::strerror(errno)));
+    }
+
+    base_ = static_cast<char*>(base);
+    header_ = new (base_) Header{};
+    states_ = reinterpret_cast<Slot*>(base_ + states_offset);
+    for (size_t slot = 0; slot < num_slots_; ++slot) {
+      new (&states_[slot]) Slot{};
+    }
+    errors_ = base_ + errors_offset;
+    slots_ = base_ + slots_offset;
+    VLOG(3) << "[ShmRing] mapped " << num_slots_ << " slots of " << slot_size_ << " bytes";
+    return absl::OkStatus();
+  }
+
+  size_t num_workers_;
+  size_t num_slots_;
+  size_t slot_size_;
+  size_t mapped_size_ = 0;
+
+  char* base_ = nullptr;
+  Header* header_ = nullptr;
+  Slot* states_ = nullptr;
+  char* errors_ = nullptr;
+  char* slots_ = nullptr;
+};
+
+}  // namespace data_flow
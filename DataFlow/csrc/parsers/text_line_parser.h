@@ -0,0 +1,445 @@
+/**
+ * @file text_line_parser.h
+ * @brief Parser of text format sample lines into SampleBatch columns.
+ *
+ * Author: Jasmine (1011694931@qq.com)
+ * Created on: 2025-11-9
+ *
+ * Copyright (c) 2025 Jasmine. All rights reserved.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+
+#include "DataFlow/csrc/common/half.h"
+#include "DataFlow/csrc/data_objects/sample_batch.h"
+
+namespace data_flow {
+
+/**
+ * @brief Options of TextLineParser.
+ *
+ * Projection: if sparse_slots/dense_slots is set, only those slots are decoded and every other
+ * slot is skipped with a delimiter scan. Every projected sparse slot is present in every batch,
+ * even if no row of the batch holds it; a projected dense slot only if some row does, as its width
+ * is unknown until then.
+ *
+ * Predicate: a row is kept only if its label is in labels (any label if empty), its timestamp is
+ * in [min_timestamp, max_timestamp], and, for negative rows (label <= 0), with probability
+ * negative_sample_rate. Only label and timestamp are decoded for rejected rows.
+ *
+ * Output dtypes: sparse ids can be stored as uint32, dense values as float16 or bfloat16 and labels
+ * as uint8. Values are converted while the line is parsed; a sparse id or label that does not fit
+ * its dtype makes the line malformed, dense values are rounded to nearest even.
+ */
+struct TextSampleOptions {
+  std::optional<std::vector<int64_t>> sparse_slots;
+  std::optional<std::vector<int64_t>> dense_slots;
+
+  std::vector<float> labels;
+  int64_t min_timestamp = std::numeric_limits<int64_t>::min();
+  int64_t max_timestamp = std::numeric_limits<int64_t>::max();
+  float negative_sample_rate = 1.0f;
+  uint64_t seed = 0;
+
+  SparseIdDType sparse_id_dtype = SparseIdDType::kUint64;
+  DenseDType dense_dtype = DenseDType::kFloat32;
+  LabelDType label_dtype = LabelDType::kFloat32;
+};
+
+/**
+ * @brief TextLineParser parses lines of the text sample format
+ *
+ *   sample_id|group_id|slot@id:weight,...;...|slot@value,...;...|label|timestamp
+ *
+ * into the columns of a SampleBatch. Lines are decoded back to front for the label and timestamp
+ * first so that rows rejected by the predicate cost no more than two number conversions.
+ */
+class TextLineParser {
+ public:
+  explicit TextLineParser(const TextSampleOptions& options = {})
+      : options_(options), rng_state_(options.seed) {
+    if (options_.sparse_slots.has_value()) {
+      wanted_sparse_.insert(options_.sparse_slots->begin(), options_.sparse_slots->end());
+    }
+    if (options_.dense_slots.has_value()) {
+      wanted_dense_.insert(options_.dense_slots->begin(), options_.dense_slots->end());
+    }
+    start_batch();
+  }
+
+  /**
+   * @brief Number of rows in the batch being built.
+   */
+  size_t rows() const { return batch_->rows(); }
+
+  /**
+   * @brief Number of rows rejected by the predicate so far.
+   */
+  uint64_t rows_filtered() const { return rows_filtered_; }
+
+  /**
+   * @brief Parse one line (without the trailing newline) and append it to the current batch.
+   * @return true if the row was appended, false if it was rejected by the predicate, or an
+   * InvalidArgument error if the line is malformed.
+   */
+  absl::StatusOr<bool> parse_line(std::string_view line) {
+    if (!line.empty() && line.back() == '\r') {
+      line.remove_suffix(1);
+    }
+
+    // label 与 timestamp 位于行尾，先从后向前解析，用于提前过滤
+    const char* begin = line.data();
+    const char* end = begin + line.size();
+    const char* ts_sep = static_cast<const char*>(memrchr(begin, '|', line.size()));
+    if (ts_sep == nullptr) {
+      return malformed(line, "missing fields");
+    }
+    const char* label_sep = static_cast<const char*>(memrchr(begin, '|', ts_sep - begin));
+    if (label_sep == nullptr) {
+      return malformed(line, "missing label");
+    }
+
+    float label = 0;
+    int64_t timestamp = 0;
+    if (!parse_number(label_sep + 1, ts_sep, &label)) {
+      return malformed(line, "bad label");
+    }
+    if (!parse_number(ts_sep + 1, end, &timestamp)) {
+      return malformed(line, "bad timestamp");
+    }
+    if (!accept(label, timestamp)) {
+      ++rows_filtered_;
+      return false;
+    }
+    if (options_.label_dtype == LabelDType::kUint8 &&
+        !(label >= 0 && label <= 255 && label == static_cast<uint8_t>(label))) {
+      return malformed(line, "label does not fit in uint8");
+    }
+
+    // sample_id|group_id|sparse|dense
+    const char* id_sep = find(begin, label_sep, '|');
+    const char* group_sep = find(id_sep + 1, label_sep, '|');
+    const char* sparse_sep = find(group_sep + 1, label_sep, '|');
+    if (sparse_sep >= label_sep) {
+      return malformed(line, "missing fields");
+    }
+
+    uint64_t group_id = 0;
+    if (!parse_number(id_sep + 1, group_sep, &group_id)) {
+      return malformed(line, "bad group_id");
+    }
+
+    const size_t row = batch_->rows();
+    auto status = parse_sparse(group_sep + 1, sparse_sep);
+    if (status.ok()) {
+      status = parse_dense(sparse_sep + 1, label_sep, row);
+    }
+    if (!status.ok()) {
+      rollback(row);
+      return malformed(line, status.message());
+    }
+
+    batch_->sample_ids().emplace_back(begin, id_sep - begin);
+    batch_->group_ids().push_back(group_id);
+    if (options_.label_dtype == LabelDType::kUint8) {
+      batch_->labels_uint8().push_back(static_cast<uint8_t>(label));
+    } else {
+      batch_->labels().push_back(label);
+    }
+    batch_->timestamps().push_back(timestamp);
+    finish_row(row);
+    return true;
+  }
+
+  /**
+   * @brief Hand out the current batch and start a new one.
+   */
+  std::shared_ptr<SampleBatch> finish_batch() {
+    // 没有任何行出现的 dense slot 宽度未知，不输出
+    auto& dense_columns = batch_->dense_columns();
+    std::vector<bool> width_known(dense_columns.size());
+    for (const auto& [slot, state] : dense_index_) {
+      width_known[state.index] = state.width_known;
+    }
+    size_t kept = 0;
+    for (size_t i = 0; i < dense_columns.size(); ++i) {
+      if (width_known[i]) {
+        if (kept != i) {
+          dense_columns[kept] = std::move(dense_columns[i]);
+        }
+        ++kept;
+      }
+    }
+    dense_columns.resize(kept);
+
+    auto batch = std::move(batch_);
+    start_batch();
+    return batch;
+  }
+
+ private:
+  static const char* find(const char* begin, const char* end, char c) {
+    const char* p = static_cast<const char*>(std::memchr(begin, c, end - begin));
+    return p == nullptr ? end : p;
+  }
+
+  template <typename T>
+  static bool parse_number(const char* begin, const char* end, T* value) {
+    auto result = std::from_chars(begin, end, *value);
+    return result.ec == std::errc() && result.ptr == end;
+  }
+
+  absl::Status malformed(std::string_view line, absl::string_view reason) const {
+    static constexpr size_t kMaxQuotedLine = 128;
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Malformed sample line (%s): %s", reason, line.substr(0, kMaxQuotedLine)));
+  }
+
+  bool accept(float label, int64_t timestamp) {
+    if (!options_.labels.empty() &&
+        std::find(options_.labels.begin(), options_.labels.end(), label) ==
+            options_.labels.end()) {
+      return false;
+    }
+    if (timestamp < options_.min_timestamp || timestamp > options_.max_timestamp) {
+      return false;
+    }
+    if (label <= 0 && options_.negative_sample_rate < 1.0f) {
+      // splitmix64
+      uint64_t z = (rng_state_ += 0x9e3779b97f4a7c15ULL);
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+      z ^= z >> 31;
+      return static_cast<double>(z >> 11) * 0x1.0p-53 < options_.negative_sample_rate;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Parse "slot@id:weight,id:weight;slot@..." into the sparse columns.
+   */
+  absl::Status parse_sparse(const char* p, const char* end) {
+    while (p < end) {
+      const char* entry_end = find(p, end, ';');
+      const char* at = find(p, entry_end, '@');
+      int64_t slot = 0;
+      if (at == entry_end || !parse_number(p, at, &slot)) {
+        return absl::InvalidArgumentError("bad sparse slot");
+      }
+      if (options_.sparse_slots.has_value() && !wanted_sparse_.contains(slot)) {
+        p = entry_end + 1;
+        continue;
+      }
+
+      SparseColumn& column = sparse_column(slot);
+      auto status = column.id_dtype == SparseIdDType::kUint32
+                        ? parse_sparse_values(at + 1, entry_end, slot, &column.ids32, &column)
+                        : parse_sparse_values(at + 1, entry_end, slot, &column.ids, &column);
+      if (!status.ok()) {
+        return status;
+      }
+      p = entry_end + 1;
+    }
+    return absl::OkStatus();
+  }
+
+  /**
+   * @brief Parse "id:weight,id:weight" into ids, of the column's id dtype, and column->weights.
+   */
+  template <typename Id>
+  static absl::Status parse_sparse_values(const char* v, const char* end, int64_t slot,
+                                          std::vector<Id>* ids, SparseColumn* column) {
+    while (v < end) {
+      const char* value_end = find(v, end, ',');
+      const char* colon = find(v, value_end, ':');
+      Id id = 0;
+      float weight = 1.0f;
+      // uint32 时超出范围的 id 由 from_chars 报错
+      if (!parse_number(v, colon, &id) ||
+          (colon != value_end && !parse_number(colon + 1, value_end, &weight))) {
+        return absl::InvalidArgumentError(absl::StrFormat("bad sparse value of slot %d", slot));
+      }
+      ids->push_back(id);
+      column->weights.push_back(weight);
+      v = value_end + 1;
+    }
+    return absl::OkStatus();
+  }
+
+  /**
+   * @brief Parse "slot@value,value;slot@..." into the dense columns.
+   */
+  absl::Status parse_dense(const char* p, const char* end, size_t row) {
+    while (p < end) {
+      const char* entry_end = find(p, end, ';');
+      const char* at = find(p, entry_end, '@');
+      int64_t slot = 0;
+      if (at == entry_end || !parse_number(p, at, &slot)) {
+        return absl::InvalidArgumentError("bad dense slot");
+      }
+      if (options_.dense_slots.has_value() && !wanted_dense_.contains(slot)) {
+        p = entry_end + 1;
+        continue;
+      }
+
+      DenseState& state = dense_column(slot);
+      if (state.last_row == row) {
+        return absl::InvalidArgumentError(absl::StrFormat("duplicated dense slot %d", slot));
+      }
+      DenseColumn& column = batch_->dense_columns()[state.index];
+      // float32 直接写入列；16 位类型先解析到 values_，再整段向量化转换
+      std::vector<float>* values = column.dtype == DenseDType::kFloat32 ? &column.values : &values_;
+      const size_t size_before = column.dtype == DenseDType::kFloat32 ? column.values.size() : 0;
+      values_.clear();
+      const char* v = at + 1;
+      while (v < entry_end) {
+        const char* value_end = find(v, entry_end, ',');
+        float value = 0;
+        if (!parse_number(v, value_end, &value)) {
+          return absl::InvalidArgumentError(absl::StrFormat("bad dense value of slot %d", slot));
+        }
+        values->push_back(value);
+        v = value_end + 1;
+      }
+
+      const size_t width = values->size() - size_before;
+      if (!state.width_known) {
+        state.width_known = true;
+        column.width = width;
+        // 该 slot 首次出现，之前的行补零
+        if (column.dtype == DenseDType::kFloat32) {
+          column.values.insert(column.values.begin(), row * width, 0.0f);
+        } else {
+          column.half_values.assign(row * width, 0);
+        }
+      } else if (width != column.width) {
+        return absl::InvalidArgumentError(absl::StrFormat(
+            "dense slot %d has %d values, expected %d", slot, width, column.width));
+      }
+      if (column.dtype != DenseDType::kFloat32) {
+        const size_t offset = column.half_values.size();
+        column.half_values.resize(offset + width);
+        if (column.dtype == DenseDType::kFloat16) {
+          Half::from_floats(values_.data(), width, column.half_values.data() + offset);
+        } else {
+          Half::bfloat16_from_floats(values_.data(), width, column.half_values.data() + offset);
+        }
+      }
+      state.last_row = row;
+      p = entry_end + 1;
+    }
+    return absl::OkStatus();
+  }
+
+  struct DenseState {
+    uint32_t index = 0;
+    bool width_known = false;
+    size_t last_row = std::numeric_limits<size_t>::max();
+  };
+
+  SparseColumn& sparse_column(int64_t slot) {
+    auto [it, inserted] = sparse_index_.try_emplace(slot, batch_->sparse_columns().size());
+    if (inserted) {
+      SparseColumn column;
+      column.slot = slot;
+      column.id_dtype = options_.sparse_id_dtype;
+      column.offsets.assign(batch_->rows() + 1, 0);
+      batch_->sparse_columns().push_back(std::move(column));
+    }
+    return batch_->sparse_columns()[it->second];
+  }
+
+  DenseState& dense_column(int64_t slot) {
+    auto [it, inserted] = dense_index_.try_emplace(slot);
+    if (inserted) {
+      it->second.index = batch_->dense_columns().size();
+      DenseColumn column;
+      column.slot = slot;
+      column.dtype = options_.dense_dtype;
+      batch_->dense_columns().push_back(std::move(column));
+    }
+    return it->second;
+  }
+
+  /**
+   * @brief Close the row: pad sparse offsets and dense values of slots missing from the row.
+   */
+  void finish_row(size_t row) {
+    for (auto& column : batch_->sparse_columns()) {
+      column.offsets.push_back(column.size());
+    }
+    for (auto& [slot, state] : dense_index_) {
+      if (state.last_row != row && state.width_known) {
+        auto& column = batch_->dense_columns()[state.index];
+        column.resize(column.size() + column.width);
+      }
+    }
+  }
+
+  /**
+   * @brief Drop the values a malformed row already appended.
+   */
+  void rollback(size_t row) {
+    for (auto& column : batch_->sparse_columns()) {
+      column.resize(column.offsets[row]);
+    }
+    for (auto& [slot, state] : dense_index_) {
+      auto& column = batch_->dense_columns()[state.index];
+      if (state.last_row == row) {
+        state.last_row = std::numeric_limits<size_t>::max();
+      }
+      if (state.width_known) {
+        column.resize(row * column.width);
+      } else {
+        column.resize(0);
+      }
+    }
+  }
+
+  void start_batch() {
+    batch_ = std::make_shared<SampleBatch>();
+    batch_->set_label_dtype(options_.label_dtype);
+    sparse_index_.clear();
+    dense_index_.clear();
+    // 投影的 sparse slot 在每个 batch 中都存在，保证输出 schema 稳定
+    if (options_.sparse_slots.has_value()) {
+      for (int64_t slot : *options_.sparse_slots) {
+        sparse_column(slot);
+      }
+    }
+    if (options_.dense_slots.has_value()) {
+      for (int64_t slot : *options_.dense_slots) {
+        dense_column(slot);
+      }
+    }
+  }
+
+  TextSampleOptions options_;
+  absl::flat_hash_set<int64_t> wanted_sparse_;
+  absl::flat_hash_set<int64_t> wanted_dense_;
+  uint64_t rng_state_;
+  uint64_t rows_filtered_ = 0;
+
+  std::shared_ptr<SampleBatch> batch_;
+  absl::flat_hash_map<int64_t, uint32_t> sparse_index_;
+  absl::flat_hash_map<int64_t, DenseState> dense_index_;
+  // 16 位 dense 类型转换前的 float 缓冲
+  std::vector<float> values_;
+};
+
+}  // namespace data_flow
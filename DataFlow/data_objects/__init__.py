@@ -2,6 +2,8 @@ import DataFlow.csrc.pybind_module as _pym
 import DataFlow.utils.api_export as api_export
 from .byte_stream import ByteStreamMeta, ByteStream
 from .inflate_stream import InflateStreamMeta, InflateStream
+from .sample_batch import SampleBatchMeta, SampleBatch
+from .shm_sample_batch import ShmSampleBatchMeta, ShmSampleBatch
 
 
 @api_export(impl=_pym.DataObjectMeta)
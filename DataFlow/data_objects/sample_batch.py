@@ -0,0 +1,35 @@
+import DataFlow.csrc.pybind_module as _pym
+import DataFlow.utils.api_export as api_export
+
+@api_export(impl=_pym.SampleBatchMeta)
+class SampleBatchMeta:
+    """ Metadata class for SampleBatch data objects."""
+    def __init__(self):
+        raise NotImplementedError("SampleBatchMeta is implemented in C++ extension.")
+    
+    @property
+    def data_type(self) -> str:
+        raise NotImplementedError("data_type is implemented in C++ extension.")
+    
+
+@api_export(impl=_pym.SampleBatch)
+class SampleBatch:
+    """ Batch of parsed samples stored as columns; columns are exposed as numpy arrays."""
+    def __init__(self):
+        raise NotImplementedError("SampleBatch is implemented in C++ extension.")
+    
+    @property
+    def data_meta(self) -> SampleBatchMeta:
+        raise NotImplementedError("data_meta is implemented in C++ extension.")
+
+    @property
+    def rows(self) -> int:
+        raise NotImplementedError("rows is implemented in C++ extension.")
+
+    def sparse(self, slot: int):
+        """ Return (ids, weights, offsets) of a sparse slot."""
+        raise NotImplementedError("sparse is implemented in C++ extension.")
+
+    def dense(self, slot: int):
+        """ Return the [rows, width] values of a dense slot."""
+        raise NotImplementedError("dense is implemented in C++ extension.")
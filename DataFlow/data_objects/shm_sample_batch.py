@@ -0,0 +1,37 @@
+import DataFlow.csrc.pybind_module as _pym
+import DataFlow.utils.api_export as api_export
+
+@api_export(impl=_pym.ShmSampleBatchMeta)
+class ShmSampleBatchMeta:
+    """ Metadata class for ShmSampleBatch data objects."""
+    def __init__(self):
+        raise NotImplementedError("ShmSampleBatchMeta is implemented in C++ extension.")
+    
+    @property
+    def data_type(self) -> str:
+        raise NotImplementedError("data_type is implemented in C++ extension.")
+    
+
+@api_export(impl=_pym.ShmSampleBatch)
+class ShmSampleBatch:
+    """ SampleBatch produced by a worker process and read in place from shared memory. Columns are
+    numpy arrays viewing the shared memory slot, which is recycled once the batch and all its arrays
+    are released."""
+    def __init__(self):
+        raise NotImplementedError("ShmSampleBatch is implemented in C++ extension.")
+    
+    @property
+    def data_meta(self) -> ShmSampleBatchMeta:
+        raise NotImplementedError("data_meta is implemented in C++ extension.")
+
+    @property
+    def rows(self) -> int:
+        raise NotImplementedError("rows is implemented in C++ extension.")
+
+    def sparse(self, slot: int):
+        """ Return (ids, weights, offsets) of a sparse slot."""
+        raise NotImplementedError("sparse is implemented in C++ extension.")
+
+    def dense(self, slot: int):
+        """ Return the [rows, width] values of a dense slot."""
+        raise NotImplementedError("dense is implemented in C++ extension.")
@@ -0,0 +1,146 @@
+/**
+ * @file compact_dtype_benchmark.cc
+ * @brief Parse throughput and batch size of TextLineParser with default and compact output
+ * dtypes, and throughput of the float16/bfloat16 array conversions.
+ *
+ * Author: Jasmine (1011694931@qq.com)
+ * Created on: 2025-11-16
+ *
+ * Copyright (c) 2025 Jasmine. All rights reserved.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "DataFlow/csrc/common/half.h"
+#include "DataFlow/csrc/parsers/text_line_parser.h"
+
+namespace {
+using data_flow::DenseDType;
+using data_flow::Half;
+using data_flow::LabelDType;
+using data_flow::SampleBatch;
+using data_flow::SparseIdDType;
+using data_flow::TextLineParser;
+using data_flow::TextSampleOptions;
+using Clock = std::chrono::steady_clock;
+
+constexpr int kLines = 100000;
+constexpr size_t kBatchSize = 1024;
+constexpr uint32_t kDenseWidth = 32;
+constexpr int kRepeats = 3;
+
+std::vector<std::string> MakeLines() {
+  std::mt19937_64 rng(42);
+  std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+  std::vector<std::string> lines;
+  char value[32];
+  for (int i = 0; i < kLines; ++i) {
+    std::string line = std::to_string(i) + "|" + std::to_string(rng() % 1000) + "|";
+    for (int slot = 1; slot <= 8; ++slot) {
+      line += (slot > 1 ? ";" : "") + std::to_string(slot) + "@";
+      for (int k = 0; k < 4; ++k) {
+        line += (k > 0 ? "," : "") + std::to_string(rng() & 0xFFFFFFFF) + ":1.0";
+      }
+    }
+    line += "|";
+    for (int slot = 101; slot <= 102; ++slot) {
+      line += (slot > 101 ? ";" : "") + std::to_string(slot) + "@";
+      for (uint32_t k = 0; k < kDenseWidth; ++k) {
+        std::snprintf(value, sizeof(value), "%s%.6f", k > 0 ? "," : "", uniform(rng));
+        line += value;
+      }
+    }
+    line += "|" + std::to_string(rng() % 2) + "|1762000000";
+    lines.push_back(std::move(line));
+  }
+  return lines;
+}
+
+size_t BatchBytes(const SampleBatch& batch) {
+  size_t bytes = batch.labels().size() * sizeof(float) + batch.labels_uint8().size();
+  for (const auto& column : batch.sparse_columns()) {
+    bytes += column.ids.size() * sizeof(uint64_t) + column.ids32.size() * sizeof(uint32_t);
+  }
+  for (const auto& column : batch.dense_columns()) {
+    bytes += column.values.size() * sizeof(float) + column.half_values.size() * sizeof(uint16_t);
+  }
+  return bytes;
+}
+
+void RunParser(const char* name, const std::vector<std::string>& lines,
+               const TextSampleOptions& options) {
+  double best = 1e30;
+  size_t bytes = 0;
+  for (int r = 0; r < kRepeats; ++r) {
+    TextLineParser parser(options);
+    bytes = 0;
+    auto start = Clock::now();
+    for (const auto& line : lines) {
+      if (!parser.parse_line(line).ok()) {
+        std::printf("%-24s parse failed\n", name);
+        return;
+      }
+      if (parser.rows() == kBatchSize) {
+        bytes += BatchBytes(*parser.finish_batch());
+      }
+    }
+    bytes += BatchBytes(*parser.finish_batch());
+    best = std::min(best, std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+  }
+  std::printf("%-24s %8.1f ns/line %8.1f bytes/row (ids, dense values, labels)\n", name,
+              best / lines.size(), static_cast<double>(bytes) / lines.size());
+}
+
+template <typename Convert>
+void RunConvert(const char* name, const std::vector<float>& src, Convert convert) {
+  std::vector<uint16_t> dst(src.size());
+  double best = 1e30;
+  for (int r = 0; r < kRepeats; ++r) {
+    auto start = Clock::now();
+    // 按 dense 行宽分段转换，与解析时的调用方式一致
+    for (size_t i = 0; i < src.size(); i += kDenseWidth) {
+      convert(src.data() + i, kDenseWidth, dst.data() + i);
+    }
+    best = std::min(best, std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+  }
+  std::printf("%-24s %8.3f ns/value\n", name, best / src.size());
+}
+}  // namespace
+
+int main() {
+  const auto lines = MakeLines();
+  std::printf("lines=%d sparse=8x4 ids dense=2x%u values\n", kLines, kDenseWidth);
+
+  TextSampleOptions options;
+  RunParser("uint64/float32/float32", lines, options);
+  options.sparse_id_dtype = SparseIdDType::kUint32;
+  options.label_dtype = LabelDType::kUint8;
+  options.dense_dtype = DenseDType::kFloat16;
+  RunParser("uint32/float16/uint8", lines, options);
+  options.dense_dtype = DenseDType::kBFloat16;
+  RunParser("uint32/bfloat16/uint8", lines, options);
+
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<float> uniform(-10.0f, 10.0f);
+  std::vector<float> values(kDenseWidth << 15);
+  for (auto& value : values) {
+    value = uniform(rng);
+  }
+  RunConvert("float16 scalar", values, [](const float* src, size_t n, uint16_t* dst) {
+    for (size_t i = 0; i < n; ++i) {
+      dst[i] = Half::from_float(src[i]);
+    }
+  });
+  RunConvert("float16 F16C", values, Half::from_floats);
+  RunConvert("bfloat16 scalar", values, [](const float* src, size_t n, uint16_t* dst) {
+    for (size_t i = 0; i < n; ++i) {
+      dst[i] = Half::bfloat16_from_float(src[i]);
+    }
+  });
+  RunConvert("bfloat16 AVX2", values, Half::bfloat16_from_floats);
+  return 0;
+}
@@ -0,0 +1,251 @@
+/**
+ * @file coroutine_scheduler_benchmark.cc
+ * @brief Reading many slow gzip FIFO streams with one thread per stream against coroutines on a
+ * Scheduler with a few worker threads.
+ *
+ * Author: Jasmine (1011694931@qq.com)
+ * Created on: 2025-11-18
+ *
+ * Copyright (c) 2025 Jasmine. All rights reserved.
+ */
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <latch>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "zlib.h"
+
+#include "DataFlow/csrc/coro/scheduler.h"
+#include "DataFlow/csrc/data_objects/byte_stream.h"
+#include "DataFlow/csrc/data_objects/inflate_stream.h"
+#include "DataFlow/csrc/io/stream_file.h"
+
+namespace {
+using data_flow::ByteStream;
+using data_flow::InflateStream;
+using data_flow::Scheduler;
+using data_flow::StreamFile;
+using data_flow::Task;
+using Clock = std::chrono::steady_clock;
+
+constexpr int kNumStreams = 256;
+constexpr size_t kLinesPerStream = 20000;
+// producer 每轮向每个流写 kPieceSize 字节，轮间隔 kRoundInterval，模拟慢速的上游
+constexpr size_t kPieceSize = 4096;
+constexpr auto kRoundInterval = std::chrono::milliseconds(5);
+constexpr size_t kBufferSize = 64 << 10;
+constexpr size_t kInflateChunkSize = 256 << 10;
+
+std::string Compress(const std::string& data) {
+  z_stream stream{};
+  deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+  std::string out(deflateBound(&stream, data.size()), '\0');
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+  stream.avail_in = data.size();
+  stream.next_out = reinterpret_cast<Bytef*>(out.data());
+  stream.avail_out = out.size();
+  deflate(&stream, Z_FINISH);
+  out.resize(stream.total_out);
+  deflateEnd(&stream);
+  return out;
+}
+
+int ThreadCount() {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.rfind("Threads:", 0) == 0) {
+      return std::stoi(line.substr(8));
+    }
+  }
+  return -1;
+}
+
+long ContextSwitches() {
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_nvcsw + usage.ru_nivcsw;
+}
+
+double CpuSeconds() {
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+         (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+/**
+ * @brief kNumStreams FIFOs fed round robin by a single paced producer thread.
+ */
+class Streams {
+ public:
+  Streams(const std::string& dir, const std::string& payload) : payload_(payload) {
+    for (int i = 0; i < kNumStreams; ++i) {
+      paths_.push_back(dir + "/stream_" + std::to_string(i));
+      ::unlink(paths_.back().c_str());
+      ::mkfifo(paths_.back().c_str(), 0600);
+    }
+  }
+
+  ~Streams() {
+    producer_.join();
+    for (const auto& path : paths_) {
+      ::unlink(path.c_str());
+    }
+  }
+
+  /**
+   * @brief Open the read ends, then the write ends, and start the producer.
+   */
+  std::vector<std::shared_ptr<InflateStream>> open() {
+    std::vector<std::shared_ptr<InflateStream>> streams;
+    for (const auto& path : paths_) {
+      auto file = StreamFile::Open("fifo://" + path).value();
+      streams.push_back(std::make_shared<InflateStream>(
+          std::make_shared<ByteStream>(std::move(file), kBufferSize)));
+    }
+    std::vector<int> fds;
+    for (const auto& path : paths_) {
+      fds.push_back(::open(path.c_str(), O_WRONLY | O_CLOEXEC));
+    }
+    producer_ = std::thread([this, fds] { produce(fds); });
+    return streams;
+  }
+
+ private:
+  void produce(std::vector<int> fds) {
+    auto next_round = Clock::now();
+    for (size_t offset = 0; offset < payload_.size(); offset += kPieceSize) {
+      const size_t size = std::min(kPieceSize, payload_.size() - offset);
+      for (int fd : fds) {
+        (void)::write(fd, payload_.data() + offset, size);
+      }
+      next_round += kRoundInterval;
+      std::this_thread::sleep_until(next_round);
+    }
+    for (int fd : fds) {
+      ::close(fd);
+    }
+  }
+
+  const std::string& payload_;
+  std::vector<std::string> paths_;
+  std::thread producer_;
+};
+
+struct Result {
+  std::atomic<size_t> bytes{0};
+  double seconds = 0;
+  double cpu_seconds = 0;
+  int threads = 0;
+  long context_switches = 0;
+};
+
+void Report(const char* name, const Result& result) {
+  std::printf("%-28s %8.1f MB/s  cpu %5.2f s  threads %4d  context switches %8ld\n", name,
+              result.bytes / result.seconds / 1e6, result.cpu_seconds, result.threads,
+              result.context_switches);
+}
+
+void ThreadPerStream(Streams& fifos, Result* result) {
+  const long switches = ContextSwitches();
+  const double cpu = CpuSeconds();
+  auto start = Clock::now();
+  auto streams = fifos.open();
+  std::vector<std::thread> threads;
+  for (auto& stream : streams) {
+    threads.emplace_back([stream, result] {
+      while (true) {
+        auto chunk = stream->read_chunk(kInflateChunkSize);
+        if (chunk.empty()) {
+          break;
+        }
+        result->bytes += chunk.size();
+      }
+    });
+  }
+  result->threads = ThreadCount();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  result->seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  result->cpu_seconds = CpuSeconds() - cpu;
+  result->context_switches = ContextSwitches() - switches;
+}
+
+Task<void> Drain(Scheduler* scheduler, std::shared_ptr<InflateStream> stream, Result* result,
+                 std::latch* done) {
+  while (true) {
+    auto chunk = co_await stream->read_chunk_async(*scheduler, kInflateChunkSize);
+    if (chunk.empty()) {
+      break;
+    }
+    result->bytes += chunk.size();
+  }
+  done->count_down();
+}
+
+void Coroutines(Streams& fifos, size_t num_threads, Result* result) {
+  const long switches = ContextSwitches();
+  const double cpu = CpuSeconds();
+  auto start = Clock::now();
+  Scheduler scheduler(num_threads);
+  auto streams = fifos.open();
+  std::latch done(streams.size());
+  for (auto& stream : streams) {
+    scheduler.spawn(Drain(&scheduler, stream, result, &done));
+  }
+  result->threads = ThreadCount();
+  done.wait();
+  result->seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  result->cpu_seconds = CpuSeconds() - cpu;
+  result->context_switches = ContextSwitches() - switches;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  const std::string dir = argc > 1 ? argv[1] : "/tmp";
+  std::string text;
+  for (size_t i = 0; i < kLinesPerStream; ++i) {
+    text += std::to_string(i) + "|" + std::to_string(i % 97) + "|1001@" + std::to_string(i * 7) +
+            ":0.5;1002@" + std::to_string(i * 13) + ":1|3@0.1,0.2|" + std::to_string(i % 2) +
+            "|" + std::to_string(1700000000 + i) + "\n";
+  }
+  const std::string payload = Compress(text);
+  std::printf("streams=%d, %zu KB gzip (%zu KB text) each, %zu KB per stream every %lld ms\n",
+              kNumStreams, payload.size() >> 10, text.size() >> 10, kPieceSize >> 10,
+              static_cast<long long>(kRoundInterval.count()));
+
+  {
+    Result result;
+    {
+      Streams fifos(dir, payload);
+      ThreadPerStream(fifos, &result);
+    }
+    Report("thread per stream", result);
+  }
+  for (size_t num_threads : {1, 2, 4}) {
+    Result result;
+    {
+      Streams fifos(dir, payload);
+      Coroutines(fifos, num_threads, &result);
+    }
+    char name[64];
+    std::snprintf(name, sizeof(name), "coroutines, %zu workers", num_threads);
+    Report(name, result);
+  }
+  return 0;
+}
@@ -0,0 +1,148 @@
+/**
+ * @file file_discovery_benchmark.cc
+ * @brief Time to the first record and full enumeration time of DataReader over a glob pattern.
+ *
+ * Author: Jasmine (1011694931@qq.com)
+ * Created on: 2025-11-12
+ *
+ * Copyright (c) 2025 Jasmine. All rights reserved.
+ */
+
+#include <dirent.h>
+#include <fnmatch.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "DataFlow/csrc/data_pipelines/data_reader.h"
+#include "DataFlow/csrc/io/file_discovery.h"
+
+namespace {
+using data_flow::ByteStream;
+using data_flow::DataReader;
+using data_flow::FileDiscovery;
+using data_flow::FileDiscoveryOptions;
+using Clock = std::chrono::steady_clock;
+
+constexpr int kDirs = 200;
+constexpr int kFilesPerDir = 500;
+
+double MillisecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void MakeTree(const std::string& root) {
+  static const char kLine[] = "s|1|1@1:1.0|2@0.5|1|1762000000\n";
+  for (int d = 0; d < kDirs; ++d) {
+    std::string dir = root + "/day=" + std::to_string(d);
+    ::mkdir(dir.c_str(), 0755);
+    for (int f = 0; f < kFilesPerDir; ++f) {
+      std::string path = dir + "/part-" + std::to_string(f) + ".txt";
+      FILE* file = std::fopen(path.c_str(), "w");
+      std::fwrite(kLine, 1, sizeof(kLine) - 1, file);
+      std::fclose(file);
+    }
+  }
+}
+
+/**
+ * @brief What a caller had to do before: list and stat every file, then start reading.
+ */
+std::vector<std::string> EagerList(const std::string& root) {
+  std::vector<std::string> files;
+  std::vector<std::string> dirs{root};
+  while (!dirs.empty()) {
+    std::string dir = dirs.back();
+    dirs.pop_back();
+    DIR* handle = ::opendir(dir.c_str());
+    while (dirent* entry = ::readdir(handle)) {
+      if (entry->d_name[0] == '.') continue;
+      std::string path = dir + "/" + entry->d_name;
+      struct stat st;
+      ::stat(path.c_str(), &st);
+      if (S_ISDIR(st.st_mode)) {
+        dirs.push_back(path);
+      } else if (fnmatch("part-*.txt", entry->d_name, 0) == 0) {
+        files.push_back(path);
+      }
+    }
+    ::closedir(handle);
+  }
+  return files;
+}
+
+bool ReadFirstRecord(DataReader* reader) {
+  auto stream = reader->next();
+  if (!stream.ok() || stream.value() == nullptr) {
+    return false;
+  }
+  auto chunk = stream.value()->as<ByteStream>().read_chunk();
+  return std::memchr(chunk.data(), '\n', chunk.size()) != nullptr;
+}
+
+void RunEager(const std::string& root) {
+  auto start = Clock::now();
+  auto files = EagerList(root);
+  DataReader reader(std::move(files));
+  bool ok = ReadFirstRecord(&reader);
+  std::printf("%-28s first record %9.2f ms %s\n", "eager list + kFileList",
+              MillisecondsSince(start), ok ? "" : "(failed)");
+}
+
+void RunPattern(const std::string& root, size_t num_threads) {
+  const std::string pattern = root + "/day=*/part-*.txt";
+  FileDiscoveryOptions options;
+  options.num_threads = num_threads;
+
+  auto start = Clock::now();
+  bool ok;
+  double first_ms;
+  {
+    DataReader reader({pattern}, DataReader::FileSource::kPattern, {}, options);
+    ok = ReadFirstRecord(&reader);
+    first_ms = MillisecondsSince(start);
+  }
+
+  start = Clock::now();
+  FileDiscovery discovery({pattern}, num_threads);
+  size_t files = 0;
+  while (true) {
+    auto entry = discovery.next();
+    if (!entry.ok() || !entry->has_value()) break;
+    ++files;
+  }
+  double all_ms = MillisecondsSince(start);
+
+  char name[64];
+  std::snprintf(name, sizeof(name), "kPattern threads=%zu", num_threads);
+  std::printf("%-28s first record %9.2f ms, all %zu files %9.2f ms %s\n", name, first_ms, files,
+              all_ms, ok ? "" : "(failed)");
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  char root_template[] = "/tmp/file_discovery_benchmark.XXXXXX";
+  std::string root = argc > 1 ? argv[1] : ::mkdtemp(root_template);
+  bool cleanup = argc <= 1;
+
+  auto start = Clock::now();
+  MakeTree(root);
+  std::printf("tree: %d dirs x %d files under %s, created in %.0f ms\n", kDirs, kFilesPerDir,
+              root.c_str(), MillisecondsSince(start));
+
+  RunEager(root);
+  for (size_t num_threads : {1, 4, 8, 16}) {
+    RunPattern(root, num_threads);
+  }
+
+  if (cleanup) {
+    std::filesystem::remove_all(root);
+  }
+  return 0;
+}
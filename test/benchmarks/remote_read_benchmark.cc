@@ -0,0 +1,278 @@
+/**
+ * @file remote_read_benchmark.cc
+ * @brief Sequential read throughput of a remote file through ReadaheadReader against an
+ * in-process HTTP server with injected per-request latency and per-connection bandwidth, and many
+ * remote files read at once by coroutines with a ReadaheadPool per file or one shared pool.
+ *
+ * Author: Jasmine (1011694931@qq.com)
+ * Created on: 2025-11-17
+ *
+ * Copyright (c) 2025 Jasmine. All rights reserved.
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <latch>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "DataFlow/csrc/coro/scheduler.h"
+#include "DataFlow/csrc/io/http_file_system.h"
+#include "DataFlow/csrc/io/readahead_reader.h"
+
+namespace {
+using data_flow::HttpFileSystem;
+using data_flow::ReadaheadOptions;
+using data_flow::ReadaheadPool;
+using data_flow::ReadaheadReader;
+using data_flow::Scheduler;
+using data_flow::Task;
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t kFileSize = 64 << 20;
+// 交错读取：kNumStreams 个远程文件各读前 kStreamBytes 字节
+constexpr int kNumStreams = 64;
+constexpr size_t kStreamBytes = 4 << 20;
+constexpr auto kLatency = std::chrono::milliseconds(20);
+// 单连接带宽上限，模拟远端存储的单流吞吐
+constexpr double kConnectionBytesPerSecond = 100e6;
+
+/**
+ * @brief Keep-alive HTTP/1.1 server of one in-memory file, one thread per connection. Every
+ * request waits kLatency before the response and the body is paced at kConnectionBytesPerSecond.
+ */
+class LatencyServer {
+ public:
+  explicit LatencyServer(const std::string& data) : data_(data) {
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    ::listen(listen_fd_, 64);
+    socklen_t len = sizeof(addr);
+    ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+    port_ = ntohs(addr.sin_port);
+    std::thread([this] { accept_loop(); }).detach();
+  }
+
+  int port() const { return port_; }
+  int max_in_flight() const { return max_in_flight_.load(); }
+
+ private:
+  void accept_loop() {
+    while (true) {
+      int fd = ::accept(listen_fd_, nullptr, nullptr);
+      if (fd < 0) {
+        return;
+      }
+      std::thread([this, fd] { serve(fd); }).detach();
+    }
+  }
+
+  void serve(int fd) {
+    std::string request;
+    char buffer[4096];
+    while (true) {
+      size_t end;
+      while ((end = request.find("\r\n\r\n")) == std::string::npos) {
+        ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0) {
+          ::close(fd);
+          return;
+        }
+        request.append(buffer, n);
+      }
+      size_t first = 0;
+      size_t last = data_.size() - 1;
+      size_t range = request.find("Range: bytes=");
+      if (range != std::string::npos && range < end) {
+        std::sscanf(request.c_str() + range, "Range: bytes=%zu-%zu", &first, &last);
+        last = std::min(last, data_.size() - 1);
+      }
+      request.erase(0, end + 4);
+
+      int in_flight = ++in_flight_;
+      int max = max_in_flight_.load();
+      while (in_flight > max && !max_in_flight_.compare_exchange_weak(max, in_flight)) {
+      }
+      std::this_thread::sleep_for(kLatency);
+      char header[256];
+      int header_size = std::snprintf(
+          header, sizeof(header),
+          "HTTP/1.1 206 Partial Content\r\nContent-Range: bytes %zu-%zu/%zu\r\n"
+          "Content-Length: %zu\r\n\r\n",
+          first, last, data_.size(), last - first + 1);
+      ::send(fd, header, header_size, MSG_NOSIGNAL);
+      auto start = Clock::now();
+      for (size_t sent = 0; sent < last - first + 1;) {
+        size_t piece = std::min<size_t>(256 << 10, last - first + 1 - sent);
+        if (::send(fd, data_.data() + first + sent, piece, MSG_NOSIGNAL) <= 0) {
+          break;
+        }
+        sent += piece;
+        std::this_thread::sleep_until(
+            start + std::chrono::duration<double>(sent / kConnectionBytesPerSecond));
+      }
+      --in_flight_;
+    }
+  }
+
+  const std::string& data_;
+  int listen_fd_;
+  int port_;
+  std::atomic<int> in_flight_{0};
+  std::atomic<int> max_in_flight_{0};
+};
+
+void Run(const char* name, const std::string& url, const ReadaheadOptions& options,
+         const LatencyServer& server) {
+  HttpFileSystem file_system;
+  auto start = Clock::now();
+  auto status_or_file = file_system.open(url);
+  if (!status_or_file.ok()) {
+    std::printf("%-32s %s\n", name, status_or_file.status().ToString().c_str());
+    return;
+  }
+  ReadaheadReader reader(std::move(status_or_file).value(), options);
+  std::vector<char> buffer(1 << 20);
+  size_t total = 0;
+  while (true) {
+    auto status_or_size = reader.read(buffer.data(), buffer.size());
+    if (!status_or_size.ok()) {
+      std::printf("%-32s %s\n", name, status_or_size.status().ToString().c_str());
+      return;
+    }
+    if (status_or_size.value() == 0) {
+      break;
+    }
+    total += status_or_size.value();
+  }
+  double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  std::printf("%-32s %8.1f MB/s (%zu bytes, max %d requests in flight)\n", name,
+              total / seconds / 1e6, total, server.max_in_flight());
+}
+
+int ThreadCount() {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.rfind("Threads:", 0) == 0) {
+      return std::stoi(line.substr(8));
+    }
+  }
+  return -1;
+}
+
+Task<void> Drain(Scheduler* scheduler, ReadaheadReader* reader, std::atomic<size_t>* total,
+                 std::latch* done) {
+  std::vector<char> buffer(1 << 20);
+  size_t read = 0;
+  while (read < kStreamBytes) {
+    auto status_or_size = co_await reader->read_async(*scheduler, buffer.data(), buffer.size());
+    if (!status_or_size.ok() || status_or_size.value() == 0) {
+      break;
+    }
+    read += status_or_size.value();
+  }
+  *total += read;
+  done->count_down();
+}
+
+/**
+ * @brief Read kNumStreams files at once on a Scheduler of 2 threads, like
+ * InterleavedTextSampleReader over remote files. With a shared pool the fetch threads stay at
+ * options.num_threads; otherwise every reader starts its own.
+ */
+void RunInterleaved(const char* name, const std::string& url, const ReadaheadOptions& options,
+                    bool shared_pool, const LatencyServer& server) {
+  HttpFileSystem file_system;
+  auto pool = shared_pool ? std::make_shared<ReadaheadPool>(options.num_threads) : nullptr;
+  auto start = Clock::now();
+  std::vector<std::unique_ptr<ReadaheadReader>> readers;
+  for (int i = 0; i < kNumStreams; ++i) {
+    auto status_or_file = file_system.open(url);
+    if (!status_or_file.ok()) {
+      std::printf("%-32s %s\n", name, status_or_file.status().ToString().c_str());
+      return;
+    }
+    readers.push_back(
+        std::make_unique<ReadaheadReader>(std::move(status_or_file).value(), options, pool));
+  }
+  std::atomic<size_t> total{0};
+  int threads = 0;
+  {
+    Scheduler scheduler(2);
+    std::latch done(kNumStreams);
+    for (auto& reader : readers) {
+      scheduler.spawn(Drain(&scheduler, reader.get(), &total, &done));
+    }
+    threads = ThreadCount();
+    done.wait();
+  }
+  double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  readers.clear();
+  std::printf("%-32s %8.1f MB/s (%zu bytes, max %d requests in flight, %d threads)\n", name,
+              total / seconds / 1e6, total.load(), server.max_in_flight(), threads);
+}
+}  // namespace
+
+int main() {
+  std::string data(kFileSize, '\0');
+  std::mt19937_64 rng(42);
+  for (size_t i = 0; i + 8 <= data.size(); i += 8) {
+    uint64_t value = rng();
+    std::memcpy(data.data() + i, &value, 8);
+  }
+  std::printf("file=%zu MB latency=%lld ms connection bandwidth=%.0f MB/s\n", kFileSize >> 20,
+              static_cast<long long>(kLatency.count()), kConnectionBytesPerSecond / 1e6);
+
+  struct Config {
+    const char* name;
+    size_t chunk_size;
+    size_t window;
+    size_t num_threads;
+  };
+  const Config configs[] = {
+      {"serial (1 thread, window 1)", 4 << 20, 1, 1},
+      {"readahead 2 threads", 4 << 20, 4, 2},
+      {"readahead 4 threads", 4 << 20, 8, 4},
+      {"readahead 8 threads", 4 << 20, 16, 8},
+      {"readahead 16 threads, 2 MB", 2 << 20, 32, 16},
+  };
+  for (const auto& config : configs) {
+    // 每个配置使用新的 server 分别统计并发请求数；连接线程已 detach，server 不释放
+    auto* server = new LatencyServer(data);
+    ReadaheadOptions options;
+    options.chunk_size = config.chunk_size;
+    options.window = config.window;
+    options.num_threads = config.num_threads;
+    Run(config.name, "http://127.0.0.1:" + std::to_string(server->port()) + "/file", options,
+        *server);
+  }
+
+  std::printf("\n%d files read at once, %zu MB each\n", kNumStreams, kStreamBytes >> 20);
+  for (bool shared_pool : {false, true}) {
+    auto* server = new LatencyServer(data);
+    ReadaheadOptions options;
+    options.chunk_size = 1 << 20;
+    options.window = 4;
+    options.num_threads = shared_pool ? 16 : 4;
+    RunInterleaved(shared_pool ? "shared pool, 16 threads" : "pool per file, 4 threads each",
+                   "http://127.0.0.1:" + std::to_string(server->port()) + "/file", options,
+                   shared_pool, *server);
+  }
+  return 0;
+}
@@ -0,0 +1,112 @@
+/**
+ * @file sparse_dedup_benchmark.cc
+ * @brief ns/id of IdDedupTable against a per-batch absl::flat_hash_map, at several unique ratios.
+ *
+ * Author: Jasmine (1011694931@qq.com)
+ * Created on: 2025-11-15
+ *
+ * Copyright (c) 2025 Jasmine. All rights reserved.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+
+#include "DataFlow/csrc/common/id_dedup_table.h"
+
+namespace {
+using data_flow::IdDedupTable;
+
+constexpr size_t kIdsPerBatch = 64 * 1024;
+constexpr int kBatches = 200;
+
+// 每个 batch 从 vocabulary 个 id 中有放回抽取，vocabulary 越小重复越多
+std::vector<std::vector<uint64_t>> MakeBatches(size_t vocabulary) {
+  std::mt19937_64 rng(42);
+  std::vector<uint64_t> vocab(vocabulary);
+  for (auto& id : vocab) {
+    id = rng();
+  }
+  std::uniform_int_distribution<size_t> pick(0, vocabulary - 1);
+  std::vector<std::vector<uint64_t>> batches(kBatches);
+  for (auto& batch : batches) {
+    batch.resize(kIdsPerBatch);
+    for (auto& id : batch) {
+      id = vocab[pick(rng)];
+    }
+  }
+  return batches;
+}
+
+double NanosecondsPerId(std::chrono::steady_clock::time_point start) {
+  auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+  return elapsed.count() / (static_cast<double>(kIdsPerBatch) * kBatches);
+}
+
+// 基线：每个 batch 新建一个哈希表
+double RunHashMap(const std::vector<std::vector<uint64_t>>& batches, size_t* unique_ids) {
+  std::vector<uint64_t> unique;
+  std::vector<uint32_t> inverse(kIdsPerBatch);
+  *unique_ids = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (const auto& batch : batches) {
+    absl::flat_hash_map<uint64_t, uint32_t> index;
+    index.reserve(batch.size());
+    unique.clear();
+    for (size_t i = 0; i < batch.size(); ++i) {
+      auto [it, inserted] = index.try_emplace(batch[i], static_cast<uint32_t>(unique.size()));
+      if (inserted) {
+        unique.push_back(batch[i]);
+      }
+      inverse[i] = it->second;
+    }
+    *unique_ids += unique.size();
+  }
+  return NanosecondsPerId(start);
+}
+
+double RunDedupTable(const std::vector<std::vector<uint64_t>>& batches, size_t* unique_ids) {
+  IdDedupTable table;
+  std::vector<uint64_t> unique;
+  std::vector<uint32_t> inverse(kIdsPerBatch);
+  *unique_ids = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (const auto& batch : batches) {
+    unique.clear();
+    table.reset(batch.size());
+    table.dedup<uint64_t>(batch, &unique, inverse.data());
+    *unique_ids += unique.size();
+  }
+  return NanosecondsPerId(start);
+}
+}  // namespace
+
+int main() {
+  std::printf("ids/batch=%zu batches=%d\n", kIdsPerBatch, kBatches);
+  // 最后一组几乎没有重复
+  const size_t vocabularies[] = {1 << 10, 1 << 14, 1 << 17, kIdsPerBatch * kBatches};
+  for (size_t vocabulary : vocabularies) {
+    const auto batches = MakeBatches(vocabulary);
+    size_t map_unique = 0;
+    size_t table_unique = 0;
+    // warm up
+    RunHashMap(batches, &map_unique);
+    RunDedupTable(batches, &table_unique);
+
+    const double map_ns = RunHashMap(batches, &map_unique);
+    const double table_ns = RunDedupTable(batches, &table_unique);
+    if (map_unique != table_unique) {
+      std::printf("unique id count mismatch: %zu vs %zu\n", map_unique, table_unique);
+      return 1;
+    }
+    const double ratio = static_cast<double>(kIdsPerBatch) * kBatches / table_unique;
+    std::printf("vocabulary=%-10zu dedup_ratio=%6.2f  flat_hash_map %6.2f ns/id  "
+                "IdDedupTable %6.2f ns/id  speedup %.2fx\n",
+                vocabulary, ratio, map_ns, table_ns, map_ns / table_ns);
+  }
+  return 0;
+}
@@ -1,3 +1,12 @@
+import gzip
+import http.server
+import json
+import math
+import os
+import socket
+import tempfile
+import threading
+import time
 import unittest
 
 import DataFlow
@@ -13,6 +22,98 @@ print(df_module.ByteStream)
 print(df_module.DataReader)
 print(df_module.DataReader.FileSource)
 
+SAMPLE_LINES = [
+    "0|11|1001@5:0.5;1002@6:1.0|3@0.1,0.2;4@0.5|1|100",
+    "1|11|1001@7:0.25|3@0.3,0.4;4@0.6|0|101",
+    "2|12|1002@8:1.0,9:2.0|3@0.5,0.6;4@0.7|1|102",
+    "3|13|1001@10:1.0|3@0.7,0.8;4@0.8|0|200",
+]
+
+
+def write_text_sample(lines):
+    """Write lines as a gzip text sample file and return its path."""
+    fd, path = tempfile.mkstemp(suffix=".gz")
+    os.close(fd)
+    with gzip.open(path, "wt") as f:
+        f.write("\n".join(lines) + "\n")
+    return path
+
+
+class RangeRequestHandler(http.server.BaseHTTPRequestHandler):
+    """Stand-in HTTP file server with Range support and the WebHDFS GETFILESTATUS/OPEN ops. Paths
+    under /norange/ ignore the Range header, like a server without range support.
+
+    Every request is delayed by server.latency and server.max_in_flight records the largest
+    number of concurrent requests.
+    """
+
+    protocol_version = "HTTP/1.1"
+
+    def log_message(self, *args):
+        pass
+
+    def reply(self, code, body=b"", headers=()):
+        self.send_response(code)
+        for name, value in headers:
+            self.send_header(name, value)
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def do_GET(self):
+        server = self.server
+        with server.lock:
+            server.in_flight += 1
+            server.max_in_flight = max(server.max_in_flight, server.in_flight)
+        try:
+            time.sleep(server.latency)
+            self.serve()
+        finally:
+            with server.lock:
+                server.in_flight -= 1
+
+    def serve(self):
+        path, _, query = self.path.partition("?")
+        params = dict(p.split("=", 1) for p in query.split("&") if "=" in p)
+        webhdfs = path.startswith("/webhdfs/v1/")
+        norange = path.startswith("/norange/")
+        prefix = "/webhdfs/v1/" if webhdfs else "/norange/" if norange else "/"
+        local = os.path.join(self.server.root, path[len(prefix) :])
+        if not os.path.isfile(local):
+            message = {"RemoteException": {"message": "File does not exist: " + path}}
+            return self.reply(404, json.dumps(message).encode())
+        size = os.path.getsize(local)
+        with open(local, "rb") as f:
+            if webhdfs and params["op"] == "GETFILESTATUS":
+                status = {"FileStatus": {"length": size, "type": "FILE"}}
+                return self.reply(200, json.dumps(status).encode())
+            if webhdfs and "datanode" not in params:
+                # namenode 将 OPEN 重定向到 datanode
+                location = "http://%s%s?%s&datanode=1" % (self.headers["Host"], path, query)
+                return self.reply(307, headers=[("Location", location)])
+            if webhdfs:
+                f.seek(int(params["offset"]))
+                return self.reply(200, f.read(int(params["length"])))
+            if norange:
+                return self.reply(200, f.read())
+            first, last = self.headers["Range"][len("bytes=") :].split("-")
+            first, last = int(first), min(int(last), size - 1)
+            if first >= size:
+                return self.reply(416, headers=[("Content-Range", "bytes */%d" % size)])
+            f.seek(first)
+            content_range = "bytes %d-%d/%d" % (first, last, size)
+            return self.reply(206, f.read(last - first + 1), [("Content-Range", content_range)])
+
+
+def start_range_server(root, latency):
+    server = http.server.ThreadingHTTPServer(("127.0.0.1", 0), RangeRequestHandler)
+    server.daemon_threads = True
+    server.root, server.latency = root, latency
+    server.lock, server.in_flight, server.max_in_flight = threading.Lock(), 0, 0
+    threading.Thread(target=server.serve_forever, daemon=True).start()
+    return server
+
+
 class TestModule(unittest.TestCase):
     def test_DataReader(self):
         file_list = ["/root/DataFlow/test/utils/text_sample.gz"]
@@ -28,6 +129,592 @@ class TestModule(unittest.TestCase):
                 break
         print(d)
 
+    def test_TextSampleParser(self):
+        path = write_text_sample(SAMPLE_LINES)
+        d = df_module.DataReader([path], file_source=df_module.DataReader.FileSource.kFileList)
+        d = df_module.DataDecompressor(d)
+        d = df_module.TextSampleParser(d, batch_size=3)
+        batches = list(d)
+        self.assertEqual([b.rows for b in batches], [3, 1])
+        self.assertEqual(batches[0].sample_ids, ["0", "1", "2"])
+        ids, weights, offsets = batches[0].sparse(1002)
+        self.assertEqual(list(ids), [6, 8, 9])
+        self.assertEqual(list(offsets), [0, 1, 1, 3])
+        self.assertEqual(batches[0].dense(3).shape, (3, 2))
+        os.remove(path)
+
+    def test_FusedTextSampleReader(self):
+        path = write_text_sample(SAMPLE_LINES)
+        d = df_module.DataReader([path], file_source=df_module.DataReader.FileSource.kFileList)
+        d = df_module.DataDecompressor(d)
+        expected = list(df_module.TextSampleParser(d, batch_size=3, labels=[1.0]))
+
+        fused = list(df_module.FusedTextSampleReader([path], batch_size=3, labels=[1.0]))
+        self.assertEqual([b.rows for b in fused], [b.rows for b in expected])
+        for got, want in zip(fused, expected):
+            self.assertEqual(got.sample_ids, want.sample_ids)
+            self.assertEqual(list(got.sparse(1002)[0]), list(want.sparse(1002)[0]))
+            self.assertEqual(got.dense(3).tolist(), want.dense(3).tolist())
+
+        # 本地文件经 FileSystemRegistry 打开，file:// uri 与路径等价
+        uri = "file://" + path
+        got = list(df_module.FusedTextSampleReader([uri], batch_size=3, labels=[1.0]))
+        self.assertEqual([b.sample_ids for b in got], [b.sample_ids for b in expected])
+        d = df_module.DataReader([uri], file_source=df_module.DataReader.FileSource.kFileList)
+        got = list(df_module.TextSampleParser(df_module.DataDecompressor(d), batch_size=3))
+        self.assertEqual([b.rows for b in got], [b.rows for b in expected])
+
+        with self.assertRaises(RuntimeError):
+            list(df_module.FusedTextSampleReader([path + ".missing"], batch_size=3))
+        os.remove(path)
+
+    def test_MultiProcessReader(self):
+        paths = [write_text_sample(SAMPLE_LINES) for _ in range(3)]
+        d = df_module.MultiProcessReader(
+            paths, num_workers=2, batch_size=3, num_slots=2, slot_size=1 << 16
+        )
+        self.assertEqual(d.num_workers, 2)
+        ids, labels, dense = [], [], []
+        for batch in d:
+            ids += batch.sample_ids
+            # 数组引用共享内存 slot，释放 batch 与数组后 slot 才会回收
+            labels += batch.labels.tolist()
+            dense.append(batch.dense(3).copy())
+        self.assertEqual(sorted(ids), sorted(["0", "1", "2", "3"] * 3))
+        self.assertEqual(sorted(labels), [0.0] * 6 + [1.0] * 6)
+        self.assertEqual(sum(x.shape[0] for x in dense), 12)
+
+        # 紧凑 dtype 原样经过共享内存
+        d = df_module.MultiProcessReader(
+            paths[:1], num_workers=1, batch_size=8, slot_size=1 << 16,
+            sparse_id_dtype="uint32", dense_dtype="float16", label_dtype="uint8"
+        )
+        (batch,) = list(d)
+        self.assertEqual(batch.labels.dtype.name, "uint8")
+        self.assertEqual(list(batch.labels), [1, 0, 1, 0])
+        ids = batch.sparse(1002)[0]
+        self.assertEqual(ids.dtype.name, "uint32")
+        self.assertEqual(list(ids), [6, 8, 9])
+        values = batch.dense(4)
+        self.assertEqual((values.dtype.name, values.shape), ("float16", (4, 1)))
+        self.assertAlmostEqual(float(values[1][0]), 0.6, places=3)
+        del batch, ids, values
+
+        # 去重在 worker 中完成，unique_ids/inverse 随 batch 经过共享内存
+        for per_slot in (True, False):
+            d = df_module.MultiProcessReader(
+                paths[:1], num_workers=1, batch_size=8, slot_size=1 << 16, dedup=True,
+                dedup_slots=[1001], dedup_per_slot=per_slot
+            )
+            (batch,) = list(d)
+            unique, inverse = batch.dedup(1001)
+            self.assertEqual([unique[i] for i in inverse], list(batch.sparse(1001)[0]))
+            with self.assertRaises(KeyError):
+                batch.dedup(1002)
+            del batch, unique, inverse
+
+        # 持有全部 slot 时 next() 报错而不是永远等待，释放后可继续读取
+        d = df_module.MultiProcessReader(
+            paths, num_workers=2, batch_size=1, num_slots=2, slot_size=1 << 16
+        )
+        it = iter(d)
+        held = [next(it), next(it)]
+        with self.assertRaisesRegex(RuntimeError, "num_slots"):
+            next(it)
+        rows = sum(b.rows for b in held)
+        held.clear()
+        self.assertEqual(rows + sum(b.rows for b in it), 12)
+
+        with self.assertRaisesRegex(ValueError, "ShmSampleBatch"):
+            df_module.GroupBatcher(d, max_rows=4)
+        with self.assertRaisesRegex(ValueError, "ShmSampleBatch"):
+            df_module.SparseDedup(d)
+
+        # 其他 pipeline 的线程仍在运行时不能 fork
+        busy = df_module.InterleavedTextSampleReader(
+            df_module.DataReader(paths, file_source=df_module.DataReader.FileSource.kFileList), 3
+        )
+        with self.assertRaisesRegex(RuntimeError, "no other DataFlow thread"):
+            df_module.MultiProcessReader(paths, num_workers=2, batch_size=3)
+        del busy
+
+        d = df_module.MultiProcessReader(paths + [paths[0] + ".missing"], num_workers=4,
+                                         batch_size=3)
+        with self.assertRaisesRegex(RuntimeError, "worker 3"):
+            list(d)
+        for path in paths:
+            os.remove(path)
+
+    def test_InterleavedTextSampleReader(self):
+        paths = [write_text_sample(SAMPLE_LINES[: i + 1]) for i in range(4)] * 2
+        d = df_module.DataReader(paths, file_source=df_module.DataReader.FileSource.kFileList)
+        expected = list(df_module.TextSampleParser(df_module.DataDecompressor(d), batch_size=3))
+
+        d = df_module.DataReader(paths, file_source=df_module.DataReader.FileSource.kFileList)
+        d = df_module.InterleavedTextSampleReader(
+            df_module.DataDecompressor(d), batch_size=3, num_threads=2, max_open_streams=3
+        )
+        batches = list(d)
+        # batch 不跨流，顺序取决于各流完成的先后
+        self.assertTrue(all(0 < b.rows <= 3 for b in batches))
+        self.assertEqual(sum(b.rows for b in batches), sum(b.rows for b in expected))
+        self.assertEqual(
+            sorted(i for b in batches for i in b.sample_ids),
+            sorted(i for b in expected for i in b.sample_ids),
+        )
+
+        d = df_module.DataReader(
+            [paths[0], paths[0] + ".missing"],
+            file_source=df_module.DataReader.FileSource.kFileList,
+        )
+        with self.assertRaises(RuntimeError):
+            list(df_module.InterleavedTextSampleReader(df_module.DataDecompressor(d), 3))
+        for path in paths[:4]:
+            os.remove(path)
+
+    def test_InterleavedTextSampleReader_streams(self):
+        root = tempfile.mkdtemp()
+        fifos = [os.path.join(root, f"samples_{i}.fifo") for i in range(4)]
+        for fifo in fifos:
+            os.mkfifo(fifo)
+
+        def produce(i, fifo):
+            # 各流交替停顿，读取方的协程在等待数据时挂起
+            with open(fifo, "w") as f:
+                for n in range(30):
+                    f.write("%d_%d|%d|1001@%d:1.0|3@0.1|1|100\n" % (i, n, i, n))
+                    f.flush()
+                    if n % 10 == i:
+                        time.sleep(0.05)
+
+        producers = [threading.Thread(target=produce, args=(i, f)) for i, f in enumerate(fifos)]
+        for producer in producers:
+            producer.start()
+        d = df_module.DataReader(fifos, file_source=df_module.DataReader.FileSource.kStream)
+        d = df_module.InterleavedTextSampleReader(
+            d, batch_size=8, num_threads=2, max_open_streams=4
+        )
+        ids = sorted(i for b in d for i in b.sample_ids)
+        self.assertEqual(ids, sorted("%d_%d" % (i, n) for i in range(4) for n in range(30)))
+        for producer in producers:
+            producer.join()
+
+        # 异步读取同样受 idle_timeout_ms 约束
+        d = df_module.DataReader(
+            fifos[:1],
+            file_source=df_module.DataReader.FileSource.kStream,
+            follow=True,
+            idle_timeout_ms=200,
+        )
+        with self.assertRaisesRegex(RuntimeError, "No data from"):
+            list(df_module.InterleavedTextSampleReader(d, batch_size=8))
+        for fifo in fifos:
+            os.remove(fifo)
+
+    def test_InterleavedTextSampleReader_destroy_mid_stream(self):
+        root = tempfile.mkdtemp()
+        fifos = [os.path.join(root, f"samples_{i}.fifo") for i in range(3)]
+        for fifo in fifos:
+            os.mkfifo(fifo)
+        # follow=True 的 FIFO 永不结束，析构时各协程仍在等待数据
+        d = df_module.DataReader(
+            fifos, file_source=df_module.DataReader.FileSource.kStream, follow=True
+        )
+        d = df_module.InterleavedTextSampleReader(d, batch_size=2, num_threads=2)
+        it = iter(d)
+
+        def produce():
+            with open(fifos[0], "w") as f:
+                f.write("\n".join(SAMPLE_LINES[:2]) + "\n")
+
+        producer = threading.Thread(target=produce)
+        producer.start()
+        self.assertEqual(next(it).rows, 2)
+        producer.join()
+        start = time.time()
+        del it, d
+        self.assertLess(time.time() - start, 5)
+        for fifo in fifos:
+            os.remove(fifo)
+
+    def test_InterleavedTextSampleReader_remote(self):
+        paths = [write_text_sample(SAMPLE_LINES[: i % 4 + 1]) for i in range(8)]
+        server = start_range_server(os.path.dirname(paths[0]), latency=0.01)
+        host = "127.0.0.1:%d" % server.server_address[1]
+        uris = [f"http://{host}/{os.path.basename(p)}" for p in paths]
+        d = df_module.DataReader(
+            uris,
+            file_source=df_module.DataReader.FileSource.kFileList,
+            readahead_chunk_size=64,
+            readahead_threads=2,
+        )
+        d = df_module.InterleavedTextSampleReader(
+            df_module.DataDecompressor(d), batch_size=3, num_threads=2
+        )
+        ids = sorted(i for b in d for i in b.sample_ids)
+        self.assertEqual(ids, sorted(str(n) for i in range(8) for n in range(i % 4 + 1)))
+        # 所有流共享 DataReader 的 2 个预读线程，另加一个打开文件的探测请求
+        self.assertLessEqual(server.max_in_flight, 3)
+        server.shutdown()
+        for path in paths:
+            os.remove(path)
+
+    def test_TextSampleParser_projection_and_predicate(self):
+        path = write_text_sample(SAMPLE_LINES)
+        d = df_module.DataReader([path], file_source=df_module.DataReader.FileSource.kFileList)
+        d = df_module.DataDecompressor(d)
+        d = df_module.TextSampleParser(
+            d, batch_size=8, sparse_slots=[1001], dense_slots=[4], max_timestamp=150
+        )
+        batches = list(d)
+        self.assertEqual(len(batches), 1)
+        self.assertEqual(batches[0].sample_ids, ["0", "1", "2"])
+        self.assertEqual(batches[0].sparse_slots, [1001])
+        self.assertEqual(batches[0].dense_slots, [4])
+        self.assertEqual(d.rows_filtered, 1)
+
+        # 没有任何行出现的 dense slot 宽度未知，不出现在 batch 中；sparse slot 则为空列
+        d = df_module.DataReader([path], file_source=df_module.DataReader.FileSource.kFileList)
+        d = df_module.DataDecompressor(d)
+        d = df_module.TextSampleParser(d, batch_size=8, sparse_slots=[999], dense_slots=[4, 99])
+        batch = next(iter(d))
+        self.assertEqual(batch.sparse_slots, [999])
+        self.assertEqual(batch.dense_slots, [4])
+        self.assertEqual(batch.dense(4).shape[0], 4)
+
+        d = df_module.DataReader([path], file_source=df_module.DataReader.FileSource.kFileList)
+        d = df_module.DataDecompressor(d)
+        d = df_module.TextSampleParser(d, batch_size=8, negative_sample_rate=0.0)
+        self.assertEqual(list(next(iter(d)).labels), [1.0, 1.0])
+        os.remove(path)
+
+    def test_TextSampleParser_output_dtypes(self):
+        path = write_text_sample(SAMPLE_LINES)
+
+        def parse(**kwargs):
+            d = df_module.DataReader([path], file_source=df_module.DataReader.FileSource.kFileList)
+            d = df_module.DataDecompressor(d)
+            return next(iter(df_module.TextSampleParser(d, batch_size=8, **kwargs)))
+
+        batch = parse(sparse_id_dtype="uint32", dense_dtype="float16", label_dtype="uint8")
+        self.assertEqual(batch.labels.dtype.name, "uint8")
+        self.assertEqual(list(batch.labels), [1, 0, 1, 0])
+        ids = batch.sparse(1002)[0]
+        self.assertEqual(ids.dtype.name, "uint32")
+        self.assertEqual(list(ids), [6, 8, 9])
+        values = batch.dense(4)
+        self.assertEqual(values.dtype.name, "float16")
+        self.assertEqual(values.shape, (4, 1))
+        self.assertAlmostEqual(float(values[1][0]), 0.6, places=3)
+
+        # bfloat16 以 uint16 位模式返回，0.5 == 0x3F00
+        batch = parse(dense_dtype="bfloat16")
+        self.assertEqual(batch.dense(4).dtype.name, "uint16")
+        self.assertEqual(int(batch.dense(4)[0][0]), 0x3F00)
+        self.assertEqual(batch.labels.dtype.name, "float32")
+
+        with self.assertRaises(ValueError):
+            parse(dense_dtype="float64")
+        os.remove(path)
+
+    def test_FeatureGenerator(self):
+        path = write_text_sample(SAMPLE_LINES)
+        d = df_module.DataReader([path], file_source=df_module.DataReader.FileSource.kFileList)
+        d = df_module.DataDecompressor(d)
+        d = df_module.TextSampleParser(d, batch_size=8)
+        d = df_module.FeatureGenerator(
+            d,
+            [
+                {"op": "bucketize", "inputs": [4], "output": 2001, "boundaries": [0.55, 0.75]},
+                {"op": "cross", "inputs": [2001, 1001], "output": 2002, "num_buckets": 100},
+                {"op": "clip", "inputs": [3], "output": 2003, "min_value": 0.2, "max_value": 0.6},
+            ],
+            keep_inputs=False,
+        )
+        batch = next(iter(d))
+        self.assertEqual(list(batch.sparse(2001)[0]), [0, 1, 1, 2])
+        self.assertEqual(list(batch.sparse(2002)[2]), [0, 1, 2, 2, 3])
+        self.assertAlmostEqual(float(batch.dense(2003).min()), 0.2, places=6)
+        self.assertNotIn(1001, batch.sparse_slots)
+        os.remove(path)
+
+    def test_FeatureGenerator_ops(self):
+        path = write_text_sample(SAMPLE_LINES)
+
+        def generate(specs, keep_inputs=True):
+            d = df_module.DataReader([path], file_source=df_module.DataReader.FileSource.kFileList)
+            d = df_module.DataDecompressor(d)
+            d = df_module.TextSampleParser(d, batch_size=8)
+            return df_module.FeatureGenerator(d, specs, keep_inputs=keep_inputs)
+
+        batch = next(iter(generate([
+            {"op": "log", "inputs": [4], "output": 2001},
+            {"op": "cross", "inputs": [1001, 1002], "output": 2002},
+            {"op": "truncate", "inputs": [1002], "output": 2003, "max_length": 1,
+             "keep_last": True},
+            {"op": "hash_mod", "inputs": [1001], "output": 2004, "num_buckets": 1 << 40},
+            {"op": "hash_mod", "inputs": [1001], "output": 2005, "num_buckets": 1 << 40,
+             "salt": 7},
+        ])))
+        for got, value in zip(batch.dense(2001)[:, 0], [0.5, 0.6, 0.7, 0.8]):
+            self.assertAlmostEqual(float(got), math.log1p(value), places=6)
+        # 只有第 0 行两个 slot 都有 id，交叉权重为两者之积
+        _, weights, offsets = batch.sparse(2002)
+        self.assertEqual((list(weights), list(offsets)), ([0.5], [0, 1, 1, 1, 1]))
+        ids, _, offsets = batch.sparse(2003)
+        self.assertEqual((list(ids), list(offsets)), ([6, 9], [0, 1, 1, 2, 2]))
+        hashed, salted = batch.sparse(2004)[0], batch.sparse(2005)[0]
+        self.assertTrue(all(i < (1 << 40) for i in hashed))
+        self.assertNotEqual(list(hashed), list(salted))
+        self.assertIn(1001, batch.sparse_slots)
+
+        again = next(iter(generate([
+            {"op": "hash_mod", "inputs": [1001], "output": 2004, "num_buckets": 1 << 40},
+        ], keep_inputs=False)))
+        self.assertEqual(list(again.sparse(2004)[0]), list(hashed))
+        self.assertEqual(again.sparse_slots, [2004])
+
+        for bad in [
+            {"op": "unknown", "inputs": [1001], "output": 2001},
+            {"op": "hash_mod", "inputs": [1001], "output": 2001, "num_buckets": 0},
+            {"op": "bucketize", "inputs": [4], "output": 2001, "boundaries": [0.7, 0.5]},
+            {"op": "clip", "inputs": [4], "output": 2001, "min_value": 1.0, "max_value": 0.0},
+            {"op": "truncate", "inputs": [1001], "output": 2001, "max_length": 0},
+            {"op": "cross", "inputs": [1001], "output": 2001},
+        ]:
+            with self.assertRaises(ValueError):
+                generate([bad])
+        with self.assertRaises(ValueError):
+            generate([
+                {"op": "hash_mod", "inputs": [2001], "output": 2002, "num_buckets": 3},
+                {"op": "hash_mod", "inputs": [2002], "output": 2001, "num_buckets": 3},
+            ])
+        os.remove(path)
+
+    def test_FeatureGenerator_in_place(self):
+        path = write_text_sample(SAMPLE_LINES)
+        d = df_module.DataReader([path], file_source=df_module.DataReader.FileSource.kFileList)
+        d = df_module.DataDecompressor(d)
+        d = df_module.TextSampleParser(d, batch_size=8)
+        d = df_module.FeatureGenerator(
+            d,
+            [
+                # 读取改写后的 1002，须排在原地改写之后
+                {"op": "truncate", "inputs": [1002], "output": 2001, "max_length": 1},
+                {"op": "hash_mod", "inputs": [1002], "output": 1002, "num_buckets": 10},
+                {"op": "clip", "inputs": [3], "output": 3, "min_value": 0.2, "max_value": 0.6},
+            ],
+        )
+        batch = next(iter(d))
+        ids, _, offsets = batch.sparse(1002)
+        self.assertTrue(all(0 <= i < 10 for i in ids))
+        self.assertEqual(list(offsets), [0, 1, 1, 3, 3])
+        self.assertEqual(list(batch.sparse(2001)[0]), list(ids[:2]))
+        self.assertEqual(batch.sparse_slots.count(1002), 1)
+        self.assertAlmostEqual(float(batch.dense(3).min()), 0.2, places=6)
+        self.assertAlmostEqual(float(batch.dense(3).max()), 0.6, places=6)
+        os.remove(path)
+
+    def test_GroupBatcher(self):
+        path = write_text_sample(SAMPLE_LINES)
+        d = df_module.DataReader([path], file_source=df_module.DataReader.FileSource.kFileList)
+        d = df_module.DataDecompressor(d)
+        d = df_module.TextSampleParser(d, batch_size=8)
+        d = df_module.GroupBatcher(d, max_rows=2)
+        batches = list(d)
+        self.assertEqual([list(b.group_ids) for b in batches], [[11, 11], [12, 13]])
+        self.assertEqual([list(b.group_offsets) for b in batches], [[0, 2], [0, 1, 2]])
+        self.assertEqual(list(batches[1].sparse(1002)[2]), [0, 2, 2])
+        os.remove(path)
+
+    def test_GroupBatcher_timeout(self):
+        fifo = os.path.join(tempfile.mkdtemp(), "groups.fifo")
+        os.mkfifo(fifo)
+        done = threading.Event()
+
+        def produce():
+            with open(fifo, "w") as f:
+                # 组 11 之后输入停顿，超时应先输出组 11，而不是等到 max_rows 行
+                for line in SAMPLE_LINES[:2] + [None] + SAMPLE_LINES[2:3] + [None]:
+                    if line is None:
+                        time.sleep(0.3)
+                        continue
+                    f.write(line + "\n")
+                    f.flush()
+            done.set()
+
+        producer = threading.Thread(target=produce)
+        producer.start()
+        d = df_module.DataReader([fifo], file_source=df_module.DataReader.FileSource.kStream)
+        d = df_module.TextSampleParser(d, batch_size=1)
+        d = df_module.GroupBatcher(d, max_rows=100, window_batches=100, timeout_ms=100)
+        it = iter(d)
+        first = next(it)
+        self.assertFalse(done.is_set())
+        self.assertEqual(list(first.group_ids), [11, 11])
+        self.assertEqual([list(b.group_ids) for b in it], [[12]])
+        producer.join()
+        os.remove(fifo)
+
+    def test_SparseDedup(self):
+        lines = SAMPLE_LINES + ["4|14|1001@5:1.0,10:1.0;1002@5:1.0|3@0.1,0.2;4@0.9|1|201"]
+        path = write_text_sample(lines)
+
+        def batches(**kwargs):
+            d = df_module.DataReader([path], file_source=df_module.DataReader.FileSource.kFileList)
+            d = df_module.DataDecompressor(d)
+            d = df_module.TextSampleParser(d, batch_size=8)
+            d = df_module.SparseDedup(d, **kwargs)
+            return d, list(d)
+
+        d, (batch,) = batches()
+        unique, inverse = batch.dedup(1001)
+        self.assertEqual(list(unique), [5, 7, 10])
+        self.assertEqual(list(inverse), [0, 1, 2, 0, 2])
+        self.assertEqual(list(batch.dedup(1002)[0]), [6, 8, 9, 5])
+        self.assertEqual(d.metrics["batches"], 1)
+        self.assertEqual((d.metrics["ids"], d.metrics["unique_ids"]), (9, 7))
+
+        d, (batch,) = batches(slots=[1002], per_slot=False)
+        with self.assertRaises(KeyError):
+            batch.dedup(1001)
+        unique, inverse = batch.dedup(1002)
+        ids = batch.sparse(1002)[0]
+        self.assertEqual([unique[i] for i in inverse], list(ids))
+        self.assertAlmostEqual(d.metrics["dedup_ratio"], 1.0)
+        os.remove(path)
+
+    def test_DataReader_fifo_stream(self):
+        fifo = os.path.join(tempfile.mkdtemp(), "samples.fifo")
+        os.mkfifo(fifo)
+
+        def produce():
+            with open(fifo, "w") as f:
+                for line in SAMPLE_LINES:
+                    f.write(line + "\n")
+                    f.flush()
+
+        producer = threading.Thread(target=produce)
+        producer.start()
+        d = df_module.DataReader([fifo], file_source=df_module.DataReader.FileSource.kStream)
+        d = df_module.TextSampleParser(d, batch_size=3)
+        self.assertEqual([b.rows for b in d], [3, 1])
+        producer.join()
+        os.remove(fifo)
+
+    def test_iterator_shared_between_threads(self):
+        lines = ["%d|%d|1001@%d:1.0|3@0.1|1|100" % (i, i, i) for i in range(2000)]
+        paths = [write_text_sample(lines) for _ in range(4)]
+        d = df_module.DataReader(paths, file_source=df_module.DataReader.FileSource.kFileList)
+        d = df_module.TextSampleParser(df_module.DataDecompressor(d), batch_size=7)
+        it = iter(d)
+        ids = [[] for _ in range(4)]
+
+        def consume(out):
+            # next() 在释放 GIL 后按 pipeline 串行执行，各线程拿到的 batch 互不重复
+            for batch in it:
+                out += batch.sample_ids
+
+        threads = [threading.Thread(target=consume, args=(out,)) for out in ids]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        expected = sorted([str(i) for i in range(2000)] * 4)
+        self.assertEqual(sorted(i for out in ids for i in out), expected)
+        for path in paths:
+            os.remove(path)
+
+    def test_DataReader_unix_socket_stream(self):
+        path = os.path.join(tempfile.mkdtemp(), "samples.sock")
+        server = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        server.bind(path)
+        server.listen(1)
+
+        def produce():
+            conn, _ = server.accept()
+            payload = ("\n".join(SAMPLE_LINES) + "\n").encode()
+            # 分片发送，验证跨 chunk 的行拼接
+            for i in range(0, len(payload), 7):
+                conn.sendall(payload[i : i + 7])
+            conn.close()
+
+        producer = threading.Thread(target=produce)
+        producer.start()
+        d = df_module.DataReader(
+            ["unix://" + path], file_source=df_module.DataReader.FileSource.kStream
+        )
+        d = df_module.TextSampleParser(d, batch_size=8)
+        batches = list(d)
+        self.assertEqual(batches[0].sample_ids, ["0", "1", "2", "3"])
+        producer.join()
+        server.close()
+        os.remove(path)
+
+    def test_DataReader_pattern(self):
+        root = tempfile.mkdtemp()
+        for day in ["20251101", "20251102"]:
+            os.makedirs(os.path.join(root, day, "sub"))
+            for i, line in enumerate(SAMPLE_LINES):
+                with open(os.path.join(root, day, "sub", f"part-{i}.txt"), "w") as f:
+                    f.write(line + "\n")
+            open(os.path.join(root, day, "empty.txt"), "w").close()
+            # 隐藏文件与 _ 开头的标记文件不是数据，"**" 与目录输入不应读到它们
+            for name in [".part-0.txt.crc", "_SUCCESS"]:
+                with open(os.path.join(root, day, "sub", name), "w") as f:
+                    f.write(SAMPLE_LINES[0] + "\n")
+
+        def count_rows(patterns, **kwargs):
+            d = df_module.DataReader(
+                patterns, file_source=df_module.DataReader.FileSource.kPattern, **kwargs
+            )
+            d = df_module.TextSampleParser(d, batch_size=100)
+            return sum(b.rows for b in d)
+
+        self.assertEqual(count_rows([os.path.join(root, "**", "part-*.txt")]), 8)
+        self.assertEqual(count_rows([os.path.join(root, "2025110[2]", "*", "*.txt")]), 4)
+        self.assertEqual(count_rows([root + "/"], lookahead=4), 8)
+        self.assertEqual(count_rows([os.path.join(root, "20251101", "sub", "_*")]), 1)
+
+        # 指向祖先目录的符号链接不会让 "**" 无限递归
+        os.symlink(root, os.path.join(root, "20251101", "sub", "loop"))
+        self.assertEqual(count_rows([os.path.join(root, "**", "part-*.txt")]), 8)
+        self.assertEqual(count_rows([root + "/"]), 8)
+
+    def test_DataReader_remote(self):
+        lines = [f"{i}|{i % 7}|1001@{i * 7919}:1.0|3@0.1,0.2|{i % 2}|{i}" for i in range(3000)]
+        path = write_text_sample(lines)
+        server = start_range_server(os.path.dirname(path), latency=0.01)
+        host = "127.0.0.1:%d" % server.server_address[1]
+        name = os.path.basename(path)
+
+        def count_rows(uri):
+            d = df_module.DataReader(
+                [uri],
+                file_source=df_module.DataReader.FileSource.kFileList,
+                readahead_chunk_size=4096,
+                readahead_window=8,
+                readahead_threads=4,
+            )
+            d = df_module.DataDecompressor(d)
+            d = df_module.TextSampleParser(d, batch_size=1000)
+            return sum(b.rows for b in d)
+
+        for uri in [f"http://{host}/{name}", f"webhdfs://{host}/{name}", f"hdfs://{host}/{name}"]:
+            self.assertEqual(count_rows(uri), len(lines), uri)
+        self.assertGreater(server.max_in_flight, 1)
+
+        fused = df_module.FusedTextSampleReader([f"http://{host}/{name}"], batch_size=1000)
+        self.assertEqual(sum(b.rows for b in fused), len(lines))
+
+        for uri in [f"http://{host}/missing.gz", f"hdfs://{host}/missing.gz"]:
+            with self.assertRaises(RuntimeError):
+                count_rows(uri)
+        with self.assertRaisesRegex(RuntimeError, "does not support range requests"):
+            count_rows(f"http://{host}/norange/{name}")
+        server.shutdown()
+        os.remove(path)
+
 
 if __name__ == "__main__":
     unittest.main()